@@ -1,55 +1,725 @@
 // DecoratorPattern_Beverage.cpp  (C++17 / VS2022)
+// Run with --bench for the decorator-chain benchmarks.
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <atomic>
+#include <array>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BEVERAGE_SSE2 1
+#endif
+
+// ----- Allocation counter (reported by --bench) -----
+// Atomic because the cache benchmark allocates from worker threads. The array,
+// nothrow and aligned forms are replaced too, so no allocation escapes the count.
+static std::atomic<std::size_t> AllocCount{ 0 };
+
+static void* countedAlloc(std::size_t n, std::size_t align) noexcept {
+    AllocCount.fetch_add(1, std::memory_order_relaxed);
+    if (n == 0) n = 1;
+    if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) return std::malloc(n);
+#ifdef _WIN32
+    return _aligned_malloc(n, align);
+#else
+    return std::aligned_alloc(align, (n + align - 1) / align * align);
+#endif
+}
+// Out of line so GCC doesn't match this free() against an inlined operator new
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+static void countedFree(void* p, std::size_t align) noexcept {
+#ifdef _WIN32
+    if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) return _aligned_free(p);
+#endif
+    (void)align;
+    std::free(p);
+}
+
+void* operator new(std::size_t n) {
+    if (void* p = countedAlloc(n, 0)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t n, std::align_val_t a) {
+    if (void* p = countedAlloc(n, std::size_t(a))) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) { return ::operator new(n); }
+void* operator new[](std::size_t n, std::align_val_t a) { return ::operator new(n, a); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return countedAlloc(n, std::size_t(a)); }
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return countedAlloc(n, std::size_t(a)); }
+void operator delete(void* p) noexcept { countedFree(p, 0); }
+void operator delete[](void* p) noexcept { countedFree(p, 0); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p, 0); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p, 0); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p, 0); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p, 0); }
+void operator delete(void* p, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete[](void* p, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete(void* p, std::size_t, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete[](void* p, std::size_t, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete(void* p, std::align_val_t a, const std::nothrow_t&) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete[](void* p, std::align_val_t a, const std::nothrow_t&) noexcept { countedFree(p, std::size_t(a)); }
+
+// ----- Layer ids -----
+// One dense id per concrete layer class, so tables index by it instead of
+// comparing names. Add an entry here for each new base or add-on.
+// A layer's kind and the layer it wraps are stored in Beverage itself, so
+// walking a chain for its kinds is a pointer chase with no virtual calls.
+enum class LayerKind : std::uint8_t { Espresso, Milk, Mocha, Whip, Count };
 
 // ----- Component -----
 struct Beverage {
+    explicit Beverage(LayerKind kind, const Beverage* inner = nullptr) : kind_(kind), inner_(inner) {}
     virtual ~Beverage() = default;
     virtual std::string description() const = 0;
     virtual double cost() const = 0;
+
+    // The description without a copy where the beverage keeps one (SealedBeverage),
+    // otherwise built into buffer. Valid while both are alive and unchanged.
+    virtual std::string_view descriptionView(std::string& buffer) const { return buffer = description(); }
+
+    // Per-layer view, used to flatten a chain without recursion (see SealedBeverage)
+    virtual const char* name() const = 0;              // this layer only
+    virtual double price() const = 0;                  // this layer only
+    LayerKind kind() const { return kind_; }           // this layer only
+    const Beverage* inner() const { return inner_; }   // wrapped beverage, if any
+
+    // A sealed beverage has no inner(); it returns the layers it flattened here,
+    // base first. walkLayers() handles both forms.
+    struct Layer { const char* name; double price; LayerKind kind; };
+    virtual const std::vector<Layer>* layers() const { return nullptr; }
+
+private:
+    LayerKind kind_;
+    const Beverage* inner_;
 };
 
+// Calls onAddOn(kind) for each add-on from the outermost in, then onBase(kind),
+// for a decorator chain and a SealedBeverage alike.
+template<class OnAddOn, class OnBase>
+void walkLayers(const Beverage& drink, OnAddOn&& onAddOn, OnBase&& onBase) {
+    if (const std::vector<Beverage::Layer>* flat = drink.layers()) {
+        for (std::size_t i = flat->size(); i-- > 1;) onAddOn((*flat)[i].kind);
+        onBase(flat->front().kind);
+        return;
+    }
+    const Beverage* b = &drink;
+    for (; b->inner(); b = b->inner()) onAddOn(b->kind());
+    onBase(b->kind());
+}
+
+// ----- Ownership -----
+// Lets a beverage live either on the heap or in an OrderArena. Arena layers are
+// only destroyed here; their memory is released with the arena. Converts from
+// std::default_delete, so std::make_unique results still plug in directly.
+struct BeverageDeleter {
+    bool inArena = false;
+
+    BeverageDeleter() = default;
+    template<class T> BeverageDeleter(std::default_delete<T>) {}
+
+    void operator()(Beverage* b) const {
+        if (inArena) b->~Beverage();
+        else delete b;
+    }
+};
+
+using BeveragePtr = std::unique_ptr<Beverage, BeverageDeleter>;
+
 // ----- Concrete Component -----
 class Espresso : public Beverage {
 public:
-    std::string description() const override { return "Espresso"; }
-    double cost() const override { return 6.00; } // RM6.00 just as an example
+    Espresso() : Beverage(kKind) {}
+    std::string description() const override { return name(); }
+    double cost() const override { return price(); }
+    static constexpr const char* kName = "Espresso";
+    static constexpr LayerKind kKind = LayerKind::Espresso;
+    static constexpr double kPrice = 6.00; // RM6.00 just as an example
+    const char* name() const override { return kName; }
+    double price() const override { return kPrice; }
 };
 
 // ----- Decorator Base -----
 class AddOn : public Beverage {
 protected:
-    std::unique_ptr<Beverage> inner_;
+    BeveragePtr inner_;
 public:
-    explicit AddOn(std::unique_ptr<Beverage> inner) : inner_(std::move(inner)) {}
+    AddOn(BeveragePtr inner, LayerKind kind) : Beverage(kind, inner.get()), inner_(std::move(inner)) {}
+
+    std::string description() const override { return inner_->description() + " + " + name(); }
+    double cost() const override { return inner_->cost() + price(); }
 };
 
 // ----- Concrete Decorators -----
 class Milk : public AddOn {
 public:
-    using AddOn::AddOn;
-    std::string description() const override { return inner_->description() + " + Milk"; }
-    double cost() const override { return inner_->cost() + 1.20; }
+    explicit Milk(BeveragePtr inner) : AddOn(std::move(inner), kKind) {}
+    static constexpr const char* kName = "Milk";
+    static constexpr LayerKind kKind = LayerKind::Milk;
+    static constexpr double kPrice = 1.20;
+    const char* name() const override { return kName; }
+    double price() const override { return kPrice; }
 };
 
 class Mocha : public AddOn {
 public:
-    using AddOn::AddOn;
-    std::string description() const override { return inner_->description() + " + Mocha"; }
-    double cost() const override { return inner_->cost() + 1.50; }
+    explicit Mocha(BeveragePtr inner) : AddOn(std::move(inner), kKind) {}
+    static constexpr const char* kName = "Mocha";
+    static constexpr LayerKind kKind = LayerKind::Mocha;
+    static constexpr double kPrice = 1.50;
+    const char* name() const override { return kName; }
+    double price() const override { return kPrice; }
 };
 
 class Whip : public AddOn {
 public:
-    using AddOn::AddOn;
-    std::string description() const override { return inner_->description() + " + Whip"; }
-    double cost() const override { return inner_->cost() + 0.80; }
+    explicit Whip(BeveragePtr inner) : AddOn(std::move(inner), kKind) {}
+    static constexpr const char* kName = "Whip";
+    static constexpr LayerKind kKind = LayerKind::Whip;
+    static constexpr double kPrice = 0.80;
+    const char* name() const override { return kName; }
+    double price() const override { return kPrice; }
+};
+
+// ----- Sealed (flattened) chain -----
+// Walks a finished decorator chain once and keeps a flat layer list, the total
+// cost (summed in the same order as the recursive cost()) and the description,
+// built with a single allocation. Later cost()/descriptionView() calls are O(1).
+// name() and price() describe the whole drink and kind() is the base's; code that needs the base and
+// add-ons (batch pricing, the pricing cache) reads layers() via walkLayers().
+class SealedBeverage : public Beverage {
+public:
+    explicit SealedBeverage(const Beverage& chain) : Beverage(baseKind(chain)) {
+        if (const std::vector<Layer>* flat = chain.layers()) layers_ = *flat;
+        else {
+            for (const Beverage* b = &chain; b; b = b->inner()) layers_.push_back({ b->name(), b->price(), b->kind() });
+            std::reverse(layers_.begin(), layers_.end()); // base first, then add-ons as applied
+        }
+
+        std::size_t length = 0;
+        for (const Layer& l : layers_) length += std::strlen(l.name) + 3;
+        description_.reserve(length);
+        for (const Layer& l : layers_) {
+            if (!description_.empty()) description_ += " + ";
+            description_ += l.name;
+            cost_ += l.price;
+        }
+    }
+
+    std::string description() const override { return description_; }
+    std::string_view descriptionView(std::string&) const override { return description_; }
+    double cost() const override { return cost_; }
+    const char* name() const override { return description_.c_str(); }
+    double price() const override { return cost_; }
+    const std::vector<Layer>* layers() const override { return &layers_; }
+
+    // Layer 0 is the base beverage, the rest are add-ons in the order applied
+    std::size_t layerCount() const { return layers_.size(); }
+    std::string_view layerName(std::size_t i) const { return layers_[i].name; }
+    double layerPrice(std::size_t i) const { return layers_[i].price; }
+
+private:
+    static LayerKind baseKind(const Beverage& chain) {
+        LayerKind base = chain.kind();
+        walkLayers(chain, [](LayerKind) {}, [&](LayerKind k) { base = k; });
+        return base;
+    }
+
+    std::string description_;
+    std::vector<Layer> layers_;
+    double cost_ = 0.0;
+};
+
+inline std::unique_ptr<SealedBeverage> seal(const Beverage& chain) {
+    return std::make_unique<SealedBeverage>(chain);
+}
+
+// ----- Per-order arena -----
+// Monotonic arena for one order's layers: make<T>() placement-constructs into
+// it and returns a BeveragePtr, and the whole order is freed at once when the
+// arena goes away. Small orders fit the inline buffer and never touch the heap.
+// Every BeveragePtr from an arena must be destroyed before the arena.
+class OrderArena {
+public:
+    OrderArena() : resource_(buffer_, sizeof buffer_) {}
+    OrderArena(const OrderArena&) = delete;
+    OrderArena& operator=(const OrderArena&) = delete;
+
+    template<class T, class...Args>
+    BeveragePtr make(Args&&...args) {
+        void* p = resource_.allocate(sizeof(T), alignof(T));
+        BeverageDeleter arenaDeleter;
+        arenaDeleter.inArena = true;
+        return BeveragePtr(new (p) T(std::forward<Args>(args)...), arenaDeleter);
+    }
+
+    // Reuse the arena for the next order (no BeveragePtr from it may be alive)
+    void reset() { resource_.release(); }
+
+private:
+    alignas(std::max_align_t) std::byte buffer_[512];
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+// ----- Batch pricing engine -----
+// For re-pricing millions of stored orders. An order is encoded as a base id
+// plus one count per add-on, kept column by column, and priced in integer
+// cents as a dot product of the counts with the price table. Cents are
+// llround(price * 100) of the same constants the classes use, so a batch total
+// equals llround(Beverage::cost() * 100) for the same drink.
+inline std::int32_t toCents(double price) { return static_cast<std::int32_t>(std::llround(price * 100)); }
+
+class PriceTable {
+public:
+    PriceTable() {
+        baseIds_.fill(kNone);
+        addOnIds_.fill(kNone);
+    }
+
+    template<class T> void addBase() { add(bases_, baseIds_, T::kKind, T::kPrice); }
+    template<class T> void addAddOn() { add(addOns_, addOnIds_, T::kKind, T::kPrice); }
+
+    static PriceTable standard() {
+        PriceTable t;
+        t.addBase<Espresso>();
+        t.addAddOn<Milk>();
+        t.addAddOn<Mocha>();
+        t.addAddOn<Whip>();
+        return t;
+    }
+
+    std::size_t baseCount() const { return bases_.size(); }
+    std::size_t addOnCount() const { return addOns_.size(); }
+    std::int32_t baseCents(std::size_t id) const { return bases_[id]; }
+    std::int32_t addOnCents(std::size_t id) const { return addOns_[id]; }
+
+    // Table ids by layer kind: one array load, no name comparison
+    std::size_t baseId(LayerKind kind) const { return find(baseIds_, kind, "base"); }
+    std::size_t addOnId(LayerKind kind) const { return find(addOnIds_, kind, "add-on"); }
+
+private:
+    static constexpr std::size_t kNone = SIZE_MAX;
+    using Ids = std::array<std::size_t, static_cast<std::size_t>(LayerKind::Count)>;
+
+    static void add(std::vector<std::int32_t>& cents, Ids& ids, LayerKind kind, double price) {
+        ids[static_cast<std::size_t>(kind)] = cents.size();
+        cents.push_back(toCents(price));
+    }
+
+    static std::size_t find(const Ids& ids, LayerKind kind, const char* what) {
+        const std::size_t id = ids[static_cast<std::size_t>(kind)];
+        if (id == kNone) throw std::runtime_error(std::string("unknown ") + what + " (layer kind " + std::to_string(int(kind)) + ")");
+        return id;
+    }
+
+    std::vector<std::int32_t> bases_;
+    std::vector<std::int32_t> addOns_;
+    Ids baseIds_;
+    Ids addOnIds_;
+};
+
+class OrderBatch {
+public:
+    explicit OrderBatch(const PriceTable& table) : table_(table), counts_(table.addOnCount()) {}
+
+    // Encode a decorator chain: innermost layer is the base, the rest are add-ons
+    void add(const Beverage& drink) {
+        for (auto& column : counts_) column.push_back(0);
+        try {
+            walkLayers(drink,
+                [&](LayerKind k) { ++counts_[table_.addOnId(k)].back(); },
+                [&](LayerKind k) { base_.push_back(static_cast<std::int32_t>(table_.baseId(k))); });
+        }
+        catch (...) {
+            for (auto& column : counts_) column.pop_back(); // unknown item: leave the batch as it was
+            throw;
+        }
+    }
+
+    std::size_t size() const { return base_.size(); }
+
+    // Totals in cents, one per order
+    void price(std::int32_t* out) const {
+        const std::size_t n = size();
+        std::vector<std::int32_t> baseCents(table_.baseCount());
+        for (std::size_t i = 0; i < baseCents.size(); ++i) baseCents[i] = table_.baseCents(i);
+        std::size_t i = 0;
+#if defined(__AVX2__)
+        for (; i + 8 <= n; i += 8) {
+            __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base_.data() + i));
+            __m256i acc = _mm256_i32gather_epi32(baseCents.data(), idx, 4);
+            for (std::size_t k = 0; k < counts_.size(); ++k) {
+                __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(counts_[k].data() + i));
+                acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(c, _mm256_set1_epi32(table_.addOnCents(k))));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), acc);
+        }
+#elif defined(BEVERAGE_SSE2)
+        for (; i + 4 <= n; i += 4) {
+            const std::int32_t* b = base_.data() + i;
+            __m128i acc = _mm_setr_epi32(baseCents[b[0]], baseCents[b[1]], baseCents[b[2]], baseCents[b[3]]);
+            for (std::size_t k = 0; k < counts_.size(); ++k) {
+                __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(counts_[k].data() + i));
+                acc = _mm_add_epi32(acc, mullo32(c, _mm_set1_epi32(table_.addOnCents(k))));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), acc);
+        }
+#endif
+        for (; i < n; ++i) { // scalar tail (and fallback)
+            std::int32_t acc = baseCents[base_[i]];
+            for (std::size_t k = 0; k < counts_.size(); ++k) acc += counts_[k][i] * table_.addOnCents(k);
+            out[i] = acc;
+        }
+    }
+
+private:
+#if defined(BEVERAGE_SSE2)
+    // SSE2 has no 32-bit mullo; build it from two 32x32->64 multiplies
+    static __m128i mullo32(__m128i a, __m128i b) {
+        __m128i even = _mm_mul_epu32(a, b);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+#endif
+
+    const PriceTable& table_;
+    std::vector<std::int32_t> base_;                // base id per order
+    std::vector<std::vector<std::int32_t>> counts_; // counts_[addOn][order]
+};
+
+// ----- Pricing cache -----
+// Bounded, thread-safe memo table: LRU per shard, one mutex per shard, and the
+// value is computed outside the lock on a miss. Each shard holds an equal share
+// of the capacity, rounded up, so up to capacity + kShards - 1 entries are kept.
+template<class V>
+class BoundedCache {
+public:
+    explicit BoundedCache(std::size_t capacity) : perShard_(std::max<std::size_t>(1, (capacity + kShards - 1) / kShards)) {}
+
+    template<class Make>
+    V get(const std::string& key, Make&& make) {
+        Shard& s = shards_[std::hash<std::string>{}(key) % kShards];
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            auto it = s.index.find(key);
+            if (it != s.index.end()) {
+                s.lru.splice(s.lru.begin(), s.lru, it->second); // most recent first
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return it->second->second;
+            }
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        V value = make();
+
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.index.find(key) == s.index.end()) { // another thread may have filled it meanwhile
+            s.lru.emplace_front(key, value);
+            s.index.emplace(key, s.lru.begin());
+            if (s.lru.size() > perShard_) {
+                s.index.erase(s.lru.back().first);
+                s.lru.pop_back();
+            }
+        }
+        return value;
+    }
+
+    std::uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    std::uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr std::size_t kShards = 16;
+    using Lru = std::list<std::pair<std::string, V>>;
+    struct Shard {
+        std::mutex mutex;
+        Lru lru;
+        std::unordered_map<std::string, typename Lru::iterator> index;
+    };
+
+    std::size_t perShard_;
+    Shard shards_[kShards];
+    std::atomic<std::uint64_t> hits_{ 0 };
+    std::atomic<std::uint64_t> misses_{ 0 };
+};
+
+// Memoizes cost and description of repeated drink compositions. Prices are in
+// cents and keyed by base + add-on multiset, so "Milk then Mocha" and "Mocha then
+// Milk" share one entry; descriptions depend on order and are keyed by the
+// exact layer sequence. quote() always takes its price from the multiset table
+// and only the description from the sequence table, so each table has its own
+// hit rate. Keys are a few bytes, built in one walk over the layer kinds.
+struct Quote {
+    std::int32_t cents;
+    std::string description;
 };
 
+class PricingCache {
+public:
+    PricingCache(const PriceTable& table, std::size_t capacity)
+        : table_(table), prices_(capacity), descriptions_(capacity) {
+    }
+
+    std::int32_t cents(const Beverage& drink) { return price(drink, keys(drink).multiset); }
+    std::string description(const Beverage& drink) { return describe(drink, keys(drink).sequence); }
+
+    Quote quote(const Beverage& drink) {
+        const Keys k = keys(drink);
+        return Quote{ price(drink, k.multiset), describe(drink, k.sequence) };
+    }
+
+    double priceHitRate() const { return rate(prices_); }
+    double descriptionHitRate() const { return rate(descriptions_); }
+
+private:
+    struct Keys {
+        std::string multiset; // [base id][count of add-on 0][count of add-on 1]...
+        std::string sequence; // [outermost add-on id]...[innermost add-on id][base id]
+    };
+
+    std::int32_t price(const Beverage& drink, const std::string& key) {
+        return prices_.get(key, [&] { return toCents(drink.cost()); });
+    }
+    std::string describe(const Beverage& drink, const std::string& key) {
+        return descriptions_.get(key, [&] { return drink.description(); });
+    }
+
+    template<class V>
+    static double rate(const BoundedCache<V>& cache) {
+        const std::uint64_t total = cache.hits() + cache.misses();
+        return total ? double(cache.hits()) / double(total) : 0.0;
+    }
+
+    // Table ids are below LayerKind::Count, so each fits one key byte exactly
+    static_assert(static_cast<std::size_t>(LayerKind::Count) <= 256, "layer ids must fit a byte");
+
+    // Counts use 7 bits per byte, high bit set on all but the last, so none
+    // is truncated and counts below 128 take a single byte
+    static void append(std::string& key, std::size_t value) {
+        for (; value >= 0x80; value >>= 7) key += static_cast<char>(0x80 | (value & 0x7f));
+        key += static_cast<char>(value);
+    }
+
+    Keys keys(const Beverage& drink) const {
+        std::array<std::size_t, static_cast<std::size_t>(LayerKind::Count)> counts{};
+        Keys k;
+        walkLayers(drink,
+            [&](LayerKind a) {
+                const std::size_t id = table_.addOnId(a);
+                k.sequence += static_cast<char>(id);
+                ++counts[id];
+            },
+            [&](LayerKind b) { k.sequence += static_cast<char>(table_.baseId(b)); });
+        k.multiset += k.sequence.back();
+        for (std::size_t i = 0; i < table_.addOnCount(); ++i) append(k.multiset, counts[i]);
+        return k;
+    }
+
+    const PriceTable& table_;
+    BoundedCache<std::int32_t> prices_;
+    BoundedCache<std::string> descriptions_;
+};
+
+// ----- Benchmark -----
+static std::unique_ptr<Beverage> makeChain(int depth) {
+    std::unique_ptr<Beverage> drink = std::make_unique<Espresso>();
+    for (int i = 0; i < depth; ++i) {
+        switch (i % 3) {
+        case 0: drink = std::make_unique<Milk>(std::move(drink)); break;
+        case 1: drink = std::make_unique<Mocha>(std::move(drink)); break;
+        default: drink = std::make_unique<Whip>(std::move(drink)); break;
+        }
+    }
+    return drink;
+}
+
+static void runBenchmark() {
+    using Clock = std::chrono::steady_clock;
+    const int calls = 200000;
+    std::cout << "cost()+description() per call, " << calls << " calls\n";
+    std::cout << "depth   chain(ns)   sealed copy(ns)   sealed view(ns)\n";
+
+    for (int depth : { 3, 5, 10, 20, 50 }) {
+        auto chain = makeChain(depth);
+        auto sealed = seal(*chain);
+        if (sealed->cost() != chain->cost() || sealed->description() != chain->description())
+            std::cout << "MISMATCH at depth " << depth << "\n";
+
+        volatile double sinkCost = 0;
+        volatile std::size_t sinkLen = 0;
+        auto time = [&](auto&& call) {
+            auto t0 = Clock::now();
+            for (int i = 0; i < calls; ++i) call();
+            return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / calls;
+        };
+        double tChain = time([&] { sinkCost = chain->cost(); sinkLen = chain->description().size(); });
+        double tCopy = time([&] { sinkCost = sealed->cost(); sinkLen = sealed->description().size(); });
+        std::string buffer;
+        double tRef = time([&] { sinkCost = sealed->cost(); sinkLen = sealed->descriptionView(buffer).size(); });
+
+        std::cout << std::setw(5) << depth << std::fixed << std::setprecision(1)
+            << std::setw(12) << tChain << std::setw(18) << tCopy << std::setw(18) << tRef << "\n";
+    }
+
+    // Batch re-pricing: decorator chains vs columnar cents kernel
+    const int orders = 1000000;
+    const int passes = 10;
+    std::mt19937 rng{ 2024 };
+    std::uniform_int_distribution<int> depthDist(0, 6);
+    std::vector<std::unique_ptr<Beverage>> history;
+    history.reserve(orders);
+    for (int i = 0; i < orders; ++i) {
+        std::unique_ptr<Beverage> drink = std::make_unique<Espresso>();
+        for (int d = depthDist(rng); d > 0; --d) {
+            switch (rng() % 3) {
+            case 0: drink = std::make_unique<Milk>(std::move(drink)); break;
+            case 1: drink = std::make_unique<Mocha>(std::move(drink)); break;
+            default: drink = std::make_unique<Whip>(std::move(drink)); break;
+            }
+        }
+        history.push_back(std::move(drink));
+    }
+
+    const PriceTable table = PriceTable::standard();
+    OrderBatch batch(table);
+    for (const auto& d : history) batch.add(*d);
+    std::vector<std::int32_t> cents(orders);
+
+    std::cout << "\nRe-price " << orders << " orders x " << passes << " passes\n";
+    std::vector<double> viaChain(orders);
+    auto t0 = Clock::now();
+    for (int p = 0; p < passes; ++p)
+        for (int i = 0; i < orders; ++i) viaChain[i] = history[i]->cost();
+    double tChain = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    t0 = Clock::now();
+    for (int p = 0; p < passes; ++p) batch.price(cents.data());
+    double tBatch = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    int mismatches = 0;
+    for (int i = 0; i < orders; ++i) mismatches += toCents(viaChain[i]) != cents[i];
+    std::cout << "Beverage::cost()  : " << std::setprecision(1) << orders * passes / tChain / 1e6 << " M orders/s\n"
+        << "OrderBatch::price(): " << orders * passes / tBatch / 1e6 << " M orders/s, "
+        << mismatches << " mismatches\n";
+    history.clear();
+
+    // Construction: one heap allocation per layer vs one arena per order
+    const int built = 1000000;
+    std::cout << "\nBuild + price " << built << " orders (Espresso + Milk + Mocha + Whip)\n";
+    volatile double sink = 0;
+    {
+        std::size_t a0 = AllocCount;
+        auto t = Clock::now();
+        for (int i = 0; i < built; ++i) {
+            std::unique_ptr<Beverage> drink = std::make_unique<Espresso>();
+            drink = std::make_unique<Milk>(std::move(drink));
+            drink = std::make_unique<Mocha>(std::move(drink));
+            drink = std::make_unique<Whip>(std::move(drink));
+            sink = drink->cost();
+        }
+        double secs = std::chrono::duration<double>(Clock::now() - t).count();
+        std::cout << "make_unique : " << built / secs / 1e6 << " M orders/s, "
+            << double(AllocCount - a0) / built << " allocs/order\n";
+    }
+    {
+        std::size_t a0 = AllocCount;
+        auto t = Clock::now();
+        for (int i = 0; i < built; ++i) {
+            OrderArena arena;
+            BeveragePtr drink = arena.make<Espresso>();
+            drink = arena.make<Milk>(std::move(drink));
+            drink = arena.make<Mocha>(std::move(drink));
+            drink = arena.make<Whip>(std::move(drink));
+            sink = drink->cost();
+        }
+        double secs = std::chrono::duration<double>(Clock::now() - t).count();
+        std::cout << "OrderArena  : " << built / secs / 1e6 << " M orders/s, "
+            << double(AllocCount - a0) / built << " allocs/order\n";
+    }
+
+    // Repeated compositions: direct chain walk vs pricing cache, several threads
+    const int lookups = 1000000;
+    const int compositions = 500;
+    const unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::unique_ptr<Beverage>> menu;
+    for (int i = 0; i < compositions; ++i) {
+        std::unique_ptr<Beverage> drink = std::make_unique<Espresso>();
+        for (int d = 1 + i % 16; d > 0; --d) {
+            switch (rng() % 3) {
+            case 0: drink = std::make_unique<Milk>(std::move(drink)); break;
+            case 1: drink = std::make_unique<Mocha>(std::move(drink)); break;
+            default: drink = std::make_unique<Whip>(std::move(drink)); break;
+            }
+        }
+        menu.push_back(std::move(drink));
+    }
+    std::vector<int> picks(lookups);
+    for (auto& p : picks) p = static_cast<int>(rng() % compositions * (rng() % compositions) / compositions); // skewed to popular drinks
+
+    auto run = [&](auto&& priceOne) {
+        std::vector<std::thread> workers;
+        auto t = Clock::now();
+        for (unsigned w = 0; w < threads; ++w)
+            workers.emplace_back([&, w] {
+                for (std::size_t i = w; i < picks.size(); i += threads) priceOne(*menu[picks[i]]);
+            });
+        for (auto& th : workers) th.join();
+        return std::chrono::duration<double>(Clock::now() - t).count();
+    };
+    PricingCache cache(table, 1024);
+    std::atomic<std::size_t> checksum{ 0 };
+    double tDirect = run([&](const Beverage& d) { checksum += d.description().size() + toCents(d.cost()); });
+    double tCached = run([&](const Beverage& d) { Quote q = cache.quote(d); checksum += q.description.size() + q.cents; });
+    int wrong = 0;
+    for (const auto& d : menu) {
+        Quote q = cache.quote(*d);
+        wrong += q.cents != toCents(d->cost()) || q.description != d->description();
+    }
+    std::cout << "\nPrice + describe " << lookups << " orders (" << compositions << " compositions, "
+        << threads << " threads, cache capacity 1024)\n"
+        << "Beverage chain: " << lookups / tDirect / 1e6 << " M orders/s\n"
+        << "PricingCache  : " << lookups / tCached / 1e6 << " M orders/s, hit rate "
+        << std::setprecision(3) << cache.priceHitRate() << " price / " << cache.descriptionHitRate()
+        << " description, " << wrong << " wrong\n";
+
+    (void)sink;
+}
+
 // ----- Demo -----
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        runBenchmark();
+        return 0;
+    }
+
     std::cout << std::fixed << std::setprecision(2);
 
     // 1) Plain espresso
@@ -75,6 +745,44 @@ int main() {
                         std::make_unique<Espresso>())));
 
         std::cout << drink->description() << " = RM" << drink->cost() << "\n";
+
+        // 4) Seal the finished chain: flat layers, cached cost and description
+        auto sealed = seal(*drink);
+        std::cout << "Sealed: " << sealed->description() << " = RM" << sealed->cost() << "\n";
+        for (std::size_t i = 0; i < sealed->layerCount(); ++i)
+            std::cout << "  " << sealed->layerName(i) << " RM" << sealed->layerPrice(i) << "\n";
+
+        // 5) Price a batch of stored orders in cents
+        const PriceTable table = PriceTable::standard();
+        OrderBatch batch(table);
+        batch.add(*drink);
+        batch.add(Milk(std::make_unique<Milk>(std::make_unique<Espresso>())));
+        batch.add(*sealed); // sealed drinks keep their layers, so they price the same
+        std::int32_t cents[3];
+        batch.price(cents);
+        std::cout << "Batch totals: " << cents[0] << " sen, " << cents[1] << " sen, " << cents[2] << " sen (sealed)\n";
+    }
+
+    // 6) Whole order built in one arena, freed together
+    {
+        OrderArena arena;
+        BeveragePtr drink = arena.make<Whip>(arena.make<Mocha>(arena.make<Espresso>()));
+        std::cout << drink->description() << " = RM" << drink->cost() << " (arena)\n";
+    }
+
+    // 7) Memoized pricing: same add-ons in a different order share the price entry
+    {
+        const PriceTable table = PriceTable::standard();
+        PricingCache cache(table, 64);
+        Mocha a(std::make_unique<Milk>(std::make_unique<Espresso>()));
+        Milk b(std::make_unique<Mocha>(std::make_unique<Espresso>()));
+        for (const Beverage* d : { static_cast<const Beverage*>(&a), static_cast<const Beverage*>(&b) })
+        {
+            Quote q = cache.quote(*d);
+            std::cout << q.description << " = " << q.cents << " sen\n";
+        }
+        std::cout << "Cache hit rate: " << cache.priceHitRate() << " price, "
+            << cache.descriptionHitRate() << " description\n";
     }
 
     return 0;
@@ -1,5 +1,14 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 // ===================== Memento =====================
@@ -21,35 +30,112 @@ private:
     std::string state_;
 };
 
+// ===================== Snapshot =====================
+// A frozen view of the editor text. It only holds shared pointers to
+// immutable chunks, so taking one is O(number of chunks), never O(text).
+// Turning it into a Memento (the expensive copy) can happen on any thread.
+class Snapshot
+{
+public:
+    using Chunk = std::shared_ptr<const std::string>;
+
+    explicit Snapshot(std::vector<Chunk> chunks)
+        : chunks_(std::move(chunks)) {
+    }
+
+    std::size_t size() const
+    {
+        std::size_t n = 0;
+        for (const auto& c : chunks_) n += c->size();
+        return n;
+    }
+
+    Memento toMemento() const
+    {
+        std::string state;
+        state.reserve(size());
+        for (const auto& c : chunks_) state += *c;
+        return Memento(std::move(state));
+    }
+
+private:
+    std::vector<Chunk> chunks_;
+};
+
 // ===================== Originator =====================
 // The object whose state we want to save/restore.
+// Text is kept as sealed immutable chunks plus a small mutable tail,
+// so a snapshot can share everything that was already written.
 class Editor
 {
 public:
     void type(const std::string& words)
     {
-        text_ += words;
+        tail_ += words;
+        frozenTail_.reset();
+        if (tail_.size() >= kChunkSize) seal();
     }
 
     void show() const
     {
-        std::cout << "Editor text: \"" << text_ << "\"\n";
+        std::cout << "Editor text: \"" << text() << "\"\n";
+    }
+
+    std::string text() const
+    {
+        std::string out;
+        for (const auto& c : sealed_) out += *c;
+        out += tail_;
+        return out;
     }
 
-    // Create a Memento that holds current state.
+    // Create a Memento that holds current state (copies the whole text).
     Memento save() const
     {
-        return Memento(text_);
+        return Memento(text());
+    }
+
+    // Cheap copy-on-write freeze: shares the sealed chunks and a copy of the
+    // tail (under kChunkSize). The tail stays mutable, so frequent freezes
+    // don't leave tiny chunks behind and a snapshot stays O(text / kChunkSize).
+    // Use this on the editing thread and build the Memento elsewhere.
+    Snapshot freeze()
+    {
+        std::vector<Snapshot::Chunk> chunks;
+        chunks.reserve(sealed_.size() + 1);
+        chunks = sealed_;
+        if (!tail_.empty())
+        {
+            if (!frozenTail_) frozenTail_ = std::make_shared<const std::string>(tail_);
+            chunks.push_back(frozenTail_);
+        }
+        return Snapshot(std::move(chunks));
     }
 
     // Restore state from a Memento.
     void restore(const Memento& m)
     {
-        text_ = m.getState();
+        sealed_.clear();
+        tail_.clear();
+        frozenTail_.reset();
+        if (!m.getState().empty())
+            sealed_.push_back(std::make_shared<const std::string>(m.getState()));
     }
 
 private:
-    std::string text_;
+    static constexpr std::size_t kChunkSize = 64 * 1024;
+
+    void seal()
+    {
+        if (tail_.empty()) return;
+        sealed_.push_back(std::make_shared<const std::string>(std::move(tail_)));
+        tail_.clear();
+        frozenTail_.reset();
+    }
+
+    std::vector<Snapshot::Chunk> sealed_;
+    std::string tail_;
+    Snapshot::Chunk frozenTail_; // copy of tail_ shared by snapshots until the next edit
 };
 
 // ===================== Caretaker =====================
@@ -84,9 +170,159 @@ private:
     std::vector<Memento> history_;
 };
 
+// ===================== Background saver =====================
+// Serializes snapshots into Mementos on a worker thread and hands each one
+// to a persist callback (push to History, write to disk, ...).
+// Callbacks run on the worker thread, in submission order.
+class AsyncSaver
+{
+public:
+    explicit AsyncSaver(std::function<void(Memento)> persist)
+        : persist_(std::move(persist)), worker_([this] { run(); }) {
+    }
+
+    ~AsyncSaver()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+        }
+        wake_.notify_one();
+        worker_.join();
+    }
+
+    AsyncSaver(const AsyncSaver&) = delete;
+    AsyncSaver& operator=(const AsyncSaver&) = delete;
+
+    void submit(Snapshot s)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push_back(std::move(s));
+        }
+        wake_.notify_one();
+    }
+
+    // Blocks until every submitted snapshot has been persisted.
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return queue_.empty() && !busy_; });
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;)
+        {
+            wake_.wait(lock, [this] { return done_ || !queue_.empty(); });
+            if (queue_.empty()) return; // done_ and drained
+
+            Snapshot s = std::move(queue_.front());
+            queue_.pop_front();
+            busy_ = true;
+            lock.unlock();
+
+            persist_(s.toMemento());
+
+            lock.lock();
+            busy_ = false;
+            if (queue_.empty()) idle_.notify_all();
+        }
+    }
+
+    std::function<void(Memento)> persist_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::deque<Snapshot> queue_;
+    bool busy_ = false;
+    bool done_ = false;
+    std::thread worker_; // last: started after everything above exists
+};
+
+// ===================== Benchmark =====================
+// Measures per-keystroke latency on the editing thread while snapshots
+// are taken every `saveEvery` keystrokes, with sync save() vs freeze().
+static void printLatency(const char* label, std::vector<double> us)
+{
+    std::sort(us.begin(), us.end());
+    auto pct = [&](double p) { return us[static_cast<std::size_t>(p * (us.size() - 1))]; };
+    std::cout << label << ": p50=" << pct(0.50) << "us p99=" << pct(0.99)
+        << "us max=" << us.back() << "us\n";
+}
+
+static void runBenchmark()
+{
+    using Clock = std::chrono::steady_clock;
+    const std::size_t docBytes = 32u << 20; // 32 MiB document
+    const int keystrokes = 10000;
+    const int saveEvery = 100;
+    const std::string page(4096, 'x');
+
+    auto makeDoc = [&] {
+        Editor e;
+        for (std::size_t n = 0; n < docBytes; n += page.size()) e.type(page);
+        return e;
+    };
+
+    std::cout << "Document " << (docBytes >> 20) << " MiB, " << keystrokes
+        << " keystrokes, snapshot every " << saveEvery << "\n";
+
+    {
+        Editor editor = makeDoc();
+        History history;
+        std::vector<double> lat;
+        lat.reserve(keystrokes);
+        for (int i = 0; i < keystrokes; ++i)
+        {
+            auto t0 = Clock::now();
+            editor.type("a");
+            if (i % saveEvery == 0)
+            {
+                history.push(editor.save());
+                history.pop(); // bound memory
+            }
+            lat.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+        }
+        printLatency("sync save()   ", lat);
+    }
+
+    {
+        Editor editor = makeDoc();
+        History history;
+        std::mutex historyMutex;
+        std::vector<double> lat;
+        lat.reserve(keystrokes);
+        {
+            AsyncSaver saver([&](Memento m) {
+                std::lock_guard<std::mutex> lock(historyMutex);
+                history.push(m);
+                if (history.canUndo()) history.pop(); // bound memory
+            });
+            for (int i = 0; i < keystrokes; ++i)
+            {
+                auto t0 = Clock::now();
+                editor.type("a");
+                if (i % saveEvery == 0) saver.submit(editor.freeze());
+                lat.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+            }
+            saver.flush();
+        }
+        printLatency("async freeze()", lat);
+    }
+}
+
 // ===================== Demo =====================
-int main()
+int main(int argc, char** argv)
 {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+    {
+        runBenchmark();
+        return 0;
+    }
+
     Editor editor;
     History history;
 
@@ -126,5 +362,22 @@ int main()
         std::cout << "Nothing to undo.\n";
     }
 
+    std::cout << "\n--- Background save ---\n";
+    {
+        std::mutex historyMutex;
+        AsyncSaver saver([&](Memento m) {
+            std::lock_guard<std::mutex> lock(historyMutex);
+            history.push(m);
+        });
+
+        editor.type("Hello again");
+        saver.submit(editor.freeze()); // cheap on this thread
+        editor.type(" (unsaved)");     // keep typing while the worker serializes
+        saver.flush();
+    }
+    editor.show();
+    editor.restore(history.pop());
+    editor.show();
+
     return 0;
 }
@@ -1,26 +1,176 @@
-// Prototype_Game_Spawner.cpp  (C++17)
-// Build: cl /std:c++17 Prototype_Game_Spawner.cpp  OR  g++ -std=c++17 Prototype_Game_Spawner.cpp -o spawner
+// Prototype_Game_Spawner.cpp  (C++20)
+// Build: cl /std:c++20 Prototype_Game_Spawner.cpp  OR  g++ -std=c++20 Prototype_Game_Spawner.cpp -o spawner
+// Run with --bench for the spawning benchmarks.
 
 #include <iostream>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <iomanip>
 #include <random>
+#include <map>
+#include <mutex>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ====== Allocation counter (reported by --bench) ======
+// Every replaceable form (array, nothrow, aligned) is defined so all
+// allocations are counted and each delete matches the new that made it.
+static std::atomic<std::size_t> AllocCount{ 0 };
+static std::atomic<std::size_t> AllocBytes{ 0 };
+
+static void* countedAlloc(std::size_t n, std::size_t align) noexcept {
+    AllocCount.fetch_add(1, std::memory_order_relaxed);
+    AllocBytes.fetch_add(n, std::memory_order_relaxed);
+    if (n == 0) n = 1;
+    if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) return std::malloc(n);
+#ifdef _WIN32
+    return _aligned_malloc(n, align);
+#else
+    return std::aligned_alloc(align, (n + align - 1) / align * align);
+#endif
+}
+// Kept out of line: once inlined into a caller, GCC pairs the free() with
+// the operator new it can see and reports a false -Wmismatched-new-delete.
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+static void countedFree(void* p, std::size_t align) noexcept {
+#ifdef _WIN32
+    if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) return _aligned_free(p);
+#endif
+    (void)align;
+    std::free(p);
+}
+
+void* operator new(std::size_t n) {
+    if (void* p = countedAlloc(n, 0)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t n, std::align_val_t a) {
+    if (void* p = countedAlloc(n, std::size_t(a))) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) { return ::operator new(n); }
+void* operator new[](std::size_t n, std::align_val_t a) { return ::operator new(n, a); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return countedAlloc(n, std::size_t(a)); }
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return countedAlloc(n, std::size_t(a)); }
+void operator delete(void* p) noexcept { countedFree(p, 0); }
+void operator delete[](void* p) noexcept { countedFree(p, 0); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p, 0); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p, 0); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p, 0); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p, 0); }
+void operator delete(void* p, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete[](void* p, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete(void* p, std::size_t, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete[](void* p, std::size_t, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete(void* p, std::align_val_t a, const std::nothrow_t&) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete[](void* p, std::align_val_t a, const std::nothrow_t&) noexcept { countedFree(p, std::size_t(a)); }
 
 // ====== Utility for IDs and RNG ======
-static int NextId = 1;
+// IDs come from one atomic counter. Each thread takes them in blocks, so the
+// shared counter is touched once per block instead of once per enemy.
+class IdAllocator {
+public:
+    // First id of a contiguous range of n ids
+    int reserve(int n) { return next_.fetch_add(n, std::memory_order_relaxed); }
+
+    int next() {
+        thread_local int cur = 0, end = 0;
+        if (cur == end) { cur = reserve(kBlock); end = cur + kBlock; }
+        return cur++;
+    }
+
+private:
+    static constexpr int kBlock = 1024;
+    std::atomic<int> next_{ 1 };
+};
+static IdAllocator Ids;
+
+// Shared engine for the single-threaded demo only; parallel code uses CounterRng.
 static std::mt19937 rng{ 12345 };
 static int rand_range(int a, int b) { std::uniform_int_distribution<int> d(a, b); return d(rng); }
 
+// Counter-based RNG: value i of a stream is a pure function of (seed, stream, i),
+// so any thread can draw any element without shared state, and the result does
+// not depend on how the work was split across threads.
+struct CounterRng {
+    std::uint64_t seed;
+    std::uint64_t stream;
+
+    static std::uint64_t mix(std::uint64_t z) { // splitmix64 finalizer
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+    std::uint64_t at(std::uint64_t i) const {
+        return mix(mix(seed ^ (stream * 0x9e3779b97f4a7c15ULL)) + i);
+    }
+    int range(std::uint64_t i, int a, int b) const {
+        return a + static_cast<int>(at(i) % static_cast<std::uint64_t>(b - a + 1));
+    }
+};
+
+// Per-enemy values a prototype contributes to a data-oriented archetype row
+struct EnemyComponents {
+    int hp, atk, aiLevel;
+    std::vector<std::string> abilities;
+};
+
 // ====== Prototype base ======
 class Enemy {
 public:
     virtual ~Enemy() = default;
     virtual std::unique_ptr<Enemy> clone() const = 0; // key
-    virtual void spawnAt(int x, int y) { x_ = x; y_ = y; id_ = NextId++; }
+    // Clone that owns its own copy of the shared traits (one per spawning thread)
+    virtual std::unique_ptr<Enemy> cloneDetached() const = 0;
+    virtual void spawnAt(int x, int y) { spawnAt(x, y, Ids.next()); }
+    void spawnAt(int x, int y, int id) { x_ = x; y_ = y; id_ = id; }
+    // Re-initialize from a prototype of the same dynamic type, reusing owned storage (pooling)
+    virtual void resetFrom(const Enemy& proto) = 0;
     virtual void info() const = 0;
+    virtual EnemyComponents components() const = 0;
+
+    // Per-tick update: step toward the origin (subclasses add regeneration)
+    virtual void tick() { x_ -= (x_ > 0) - (x_ < 0); y_ -= (y_ > 0) - (y_ < 0); }
+
+    int id() const { return id_; }
+    int x() const { return x_; }
+    int y() const { return y_; }
 
 protected:
     // shared attributes
@@ -28,93 +178,1009 @@ protected:
     int x_ = 0, y_ = 0;
 };
 
-// ====== A small owned subobject to show deep copy ======
+// ====== A small subobject owned by the prototype ======
 struct Brain {
     int aiLevel;
     std::string behavior;
-    std::unique_ptr<Brain> clone() const { return std::make_unique<Brain>(*this); }
+};
+
+// ====== Copy-on-write holder for prototype-owned data ======
+// Clones share one immutable T; the first mutation through edit() gives that
+// clone its own copy, so cloning costs a refcount bump instead of a deep copy.
+template<class T>
+class CowPtr {
+public:
+    explicit CowPtr(T value) : p_(std::make_shared<T>(std::move(value))) {}
+
+    const T& operator*() const { return *p_; }
+    const T* operator->() const { return p_.get(); }
+
+    T& edit() {
+        detach();
+        return *p_;
+    }
+
+    // Take a private copy now, so later copies of this holder share it instead
+    void detach() {
+        if (p_.use_count() != 1) p_ = std::make_shared<T>(*p_);
+    }
+
+private:
+    std::shared_ptr<T> p_;
 };
 
 // ====== Concrete prototypes ======
 class Orc : public Enemy {
 public:
     Orc(int hp = 100, int atk = 12, std::vector<std::string> abilities = { "Roar" })
-        : hp_(hp), atk_(atk), abilities_(std::move(abilities)), brain_(std::make_unique<Brain>(Brain{ 1,"Aggressive" })) {
+        : hp_(hp), atk_(atk), traits_(Traits{ std::move(abilities), Brain{ 1,"Aggressive" } }) {
     }
 
-    Orc(const Orc& o) : hp_(o.hp_), atk_(o.atk_), abilities_(o.abilities_) {
-        brain_ = o.brain_->clone(); // deep copy owned object
-    }
+    Orc(const Orc&) = default; // shares traits_ until a mutator copies them
 
     std::unique_ptr<Enemy> clone() const override { return std::make_unique<Orc>(*this); }
+    std::unique_ptr<Enemy> cloneDetached() const override {
+        auto c = std::make_unique<Orc>(*this);
+        c->traits_.detach();
+        return c;
+    }
 
-    void addAbility(std::string a) { abilities_.push_back(std::move(a)); }
-    void setAI(int lvl, std::string beh) { brain_->aiLevel = lvl; brain_->behavior = std::move(beh); }
+    void resetFrom(const Enemy& proto) override {
+        const auto& o = static_cast<const Orc&>(proto);
+        hp_ = o.hp_; atk_ = o.atk_;
+        traits_ = o.traits_;
+    }
+
+    EnemyComponents components() const override { return { hp_, atk_, traits_->brain.aiLevel, traits_->abilities }; }
+    void tick() override { Enemy::tick(); hp_ += traits_->brain.aiLevel; }
+
+    void addAbility(std::string a) { traits_.edit().abilities.push_back(std::move(a)); }
+    void setAI(int lvl, std::string beh) {
+        Brain& b = traits_.edit().brain;
+        b.aiLevel = lvl; b.behavior = std::move(beh);
+    }
 
     void info() const override {
+        const auto& abilities = traits_->abilities;
         std::cout << "Orc  #" << id_ << " @(" << x_ << "," << y_ << ") "
             << "HP=" << hp_ << " ATK=" << atk_
-            << " AI(lv=" << brain_->aiLevel << "," << brain_->behavior << ") Abil=[";
-        for (size_t i = 0; i < abilities_.size(); ++i) { std::cout << abilities_[i] << (i + 1 < abilities_.size() ? "," : ""); }
+            << " AI(lv=" << traits_->brain.aiLevel << "," << traits_->brain.behavior << ") Abil=[";
+        for (size_t i = 0; i < abilities.size(); ++i) { std::cout << abilities[i] << (i + 1 < abilities.size() ? "," : ""); }
         std::cout << "]\n";
     }
 
 private:
+    struct Traits {
+        std::vector<std::string> abilities;
+        Brain brain;
+    };
+
     int hp_, atk_;
-    std::vector<std::string> abilities_;
-    std::unique_ptr<Brain> brain_;
+    CowPtr<Traits> traits_;
 };
 
 class Dragon : public Enemy {
 public:
     Dragon(int hp = 300, int atk = 35, std::string element = "Fire")
-        : hp_(hp), atk_(atk), element_(std::move(element)), brain_(std::make_unique<Brain>(Brain{ 3,"Territorial" })) {
+        : hp_(hp), atk_(atk), traits_(Traits{ std::move(element), Brain{ 3,"Territorial" } }) {
     }
 
-    Dragon(const Dragon& d) : hp_(d.hp_), atk_(d.atk_), element_(d.element_) {
-        brain_ = d.brain_->clone();
-    }
+    Dragon(const Dragon&) = default; // shares traits_ until a mutator copies them
 
     std::unique_ptr<Enemy> clone() const override { return std::make_unique<Dragon>(*this); }
+    std::unique_ptr<Enemy> cloneDetached() const override {
+        auto c = std::make_unique<Dragon>(*this);
+        c->traits_.detach();
+        return c;
+    }
+
+    void resetFrom(const Enemy& proto) override {
+        const auto& d = static_cast<const Dragon&>(proto);
+        hp_ = d.hp_; atk_ = d.atk_;
+        traits_ = d.traits_;
+    }
+
+    EnemyComponents components() const override { return { hp_, atk_, traits_->brain.aiLevel, {} }; }
+    void tick() override { Enemy::tick(); hp_ += traits_->brain.aiLevel; }
 
     void empower(int bonus) { atk_ += bonus; }
-    void setElement(std::string e) { element_ = std::move(e); }
+    void setElement(std::string e) { traits_.edit().element = std::move(e); }
 
     void info() const override {
         std::cout << "Dragon#" << id_ << " @(" << x_ << "," << y_ << ") "
             << "HP=" << hp_ << " ATK=" << atk_
-            << " Elem=" << element_
-            << " AI(lv=" << brain_->aiLevel << "," << brain_->behavior << ")\n";
+            << " Elem=" << traits_->element
+            << " AI(lv=" << traits_->brain.aiLevel << "," << traits_->brain.behavior << ")\n";
     }
 
 private:
+    struct Traits {
+        std::string element;
+        Brain brain;
+    };
+
     int hp_, atk_;
-    std::string element_;
-    std::unique_ptr<Brain> brain_;
+    CowPtr<Traits> traits_;
+};
+
+// ====== Per-prototype object pool ======
+// Keeps every enemy it ever cloned. Released enemies go back on a free list and
+// are re-initialized from the prototype with resetFrom(), so once a pool is warm
+// a wave of the same size allocates nothing.
+class EnemyPool;
+
+struct PoolReturn {
+    EnemyPool* pool = nullptr;
+    void operator()(Enemy* e) const;
+};
+
+// unique_ptr that hands the enemy back to its pool instead of deleting it.
+// The owning EnemySpawner must outlive every PooledEnemy, and a prototype
+// cannot be re-registered while any of its pooled enemies are still out.
+using PooledEnemy = std::unique_ptr<Enemy, PoolReturn>;
+
+struct Position { int x, y; };
+
+class EnemyPool {
+public:
+    explicit EnemyPool(const Enemy& proto) : proto_(proto) {}
+
+    PooledEnemy acquire(int x, int y) {
+        Enemy* e;
+        if (free_.empty()) {
+            storage_.push_back(proto_.clone());
+            free_.reserve(storage_.capacity());
+            e = storage_.back().get();
+        }
+        else {
+            e = free_.back();
+            free_.pop_back();
+            e->resetFrom(proto_);
+        }
+        e->spawnAt(x, y);
+        return PooledEnemy(e, PoolReturn{ this });
+    }
+
+    void release(Enemy* e) { free_.push_back(e); }
+
+    // Bulk path for parallel spawning: fills the front of slots with free
+    // enemies and returns how many; the caller clones the rest into grow() slots.
+    std::size_t takeFree(std::span<Enemy*> slots) {
+        std::size_t n = std::min(slots.size(), free_.size());
+        std::copy(free_.end() - n, free_.end(), slots.begin());
+        free_.resize(free_.size() - n);
+        return n;
+    }
+
+    // Appends n empty storage slots and returns the first index. Threads may
+    // then fill() distinct slots concurrently; nothing else may run meanwhile.
+    std::size_t grow(std::size_t n) {
+        const std::size_t first = storage_.size();
+        storage_.resize(first + n);
+        free_.reserve(storage_.capacity());
+        return first;
+    }
+
+    Enemy* fill(std::size_t slot, std::unique_ptr<Enemy> e) {
+        storage_[slot] = std::move(e);
+        return storage_[slot].get();
+    }
+
+    // Drops grow() slots from `first` on that were never filled
+    void trimEmpty(std::size_t first) {
+        storage_.erase(std::remove(storage_.begin() + first, storage_.end(), nullptr), storage_.end());
+    }
+
+    PooledEnemy handle(Enemy* e) { return PooledEnemy(e, PoolReturn{ this }); }
+
+    const Enemy& prototype() const { return proto_; }
+
+    // Detached copies of the prototype, one per spawnWave() worker, kept for the
+    // pool's lifetime: an enemy reset from the same copy as last wave touches
+    // no refcount at all, and different workers never share one.
+    std::span<const std::unique_ptr<Enemy>> workerPrototypes(unsigned n) {
+        while (workerProtos_.size() < n) workerProtos_.push_back(proto_.cloneDetached());
+        return { workerProtos_.data(), n };
+    }
+    std::size_t capacity() const { return storage_.size(); }
+    std::size_t outstanding() const { return storage_.size() - free_.size(); }
+
+private:
+    const Enemy& proto_;
+    std::vector<std::unique_ptr<Enemy>> storage_;
+    std::vector<std::unique_ptr<Enemy>> workerProtos_;
+    std::vector<Enemy*> free_;
+};
+
+inline void PoolReturn::operator()(Enemy* e) const { pool->release(e); }
+
+// ====== Data-oriented storage (ECS-style archetypes) ======
+// Each registered prototype defines an archetype: one column per component,
+// one row per enemy. Spawning is a row copy of the prototype's components and
+// systems walk the columns linearly, with no virtual calls or pointer chasing.
+class Archetype {
+public:
+    Archetype(std::string name, const EnemyComponents& proto, int abilitySet)
+        : name_(std::move(name)), proto_{ proto.hp, proto.atk, proto.aiLevel }, protoAbilitySet_(abilitySet) {
+    }
+
+    void spawn(std::span<const Position> at) {
+        const int base = Ids.reserve(static_cast<int>(at.size()));
+        const std::size_t n = size() + at.size();
+        id.reserve(n); hp.reserve(n); atk.reserve(n); x.reserve(n); y.reserve(n);
+        aiLevel.reserve(n); abilitySet.reserve(n);
+        for (std::size_t i = 0; i < at.size(); ++i) {
+            id.push_back(base + static_cast<int>(i));
+            hp.push_back(proto_.hp);
+            atk.push_back(proto_.atk);
+            x.push_back(at[i].x);
+            y.push_back(at[i].y);
+            aiLevel.push_back(proto_.aiLevel);
+            abilitySet.push_back(protoAbilitySet_);
+        }
+    }
+
+    void clear() {
+        id.clear(); hp.clear(); atk.clear(); x.clear(); y.clear(); aiLevel.clear(); abilitySet.clear();
+    }
+
+    std::size_t size() const { return id.size(); }
+    const std::string& name() const { return name_; }
+
+    // Component columns
+    std::vector<int> id, hp, atk, x, y, aiLevel, abilitySet;
+
+private:
+    struct Row { int hp, atk, aiLevel; };
+    std::string name_;
+    Row proto_;
+    int protoAbilitySet_;
+};
+
+// Archetypes live in a deque, so the Archetype& that archetype() and spawnN()
+// return stays valid when more prototypes are registered. Re-registering a key
+// resets its archetype in place.
+class EnemyWorld {
+public:
+    void addArchetype(const std::string& key, const Enemy& proto) {
+        EnemyComponents c = proto.components();
+        const int set = internAbilities(c.abilities);
+        auto it = index_.find(key);
+        if (it != index_.end()) archetypes_[it->second] = Archetype(key, c, set);
+        else {
+            index_[key] = archetypes_.size();
+            archetypes_.emplace_back(key, c, set);
+        }
+    }
+
+    Archetype& archetype(const std::string& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) throw std::runtime_error("no archetype: " + key);
+        return archetypes_[it->second];
+    }
+
+    Archetype& spawnN(const std::string& key, std::span<const Position> at) {
+        Archetype& a = archetype(key);
+        a.spawn(at);
+        return a;
+    }
+
+    // Movement + regeneration system; same rules as Enemy::tick()
+    void tick() {
+        for (auto& a : archetypes_) {
+            const std::size_t n = a.size();
+            int* x = a.x.data(); int* y = a.y.data(); int* hp = a.hp.data();
+            const int* ai = a.aiLevel.data();
+            for (std::size_t i = 0; i < n; ++i) {
+                x[i] -= (x[i] > 0) - (x[i] < 0);
+                y[i] -= (y[i] > 0) - (y[i] < 0);
+                hp[i] += ai[i];
+            }
+        }
+    }
+
+    const std::vector<std::string>& abilities(int set) const { return abilitySets_[set]; }
+
+    void info(const Archetype& a, std::size_t row) const {
+        std::cout << a.name() << " #" << a.id[row] << " @(" << a.x[row] << "," << a.y[row] << ") "
+            << "HP=" << a.hp[row] << " ATK=" << a.atk[row] << " AI(lv=" << a.aiLevel[row] << ") Abil=[";
+        const auto& abil = abilities(a.abilitySet[row]);
+        for (size_t i = 0; i < abil.size(); ++i) { std::cout << abil[i] << (i + 1 < abil.size() ? "," : ""); }
+        std::cout << "]\n";
+    }
+
+private:
+    int internAbilities(const std::vector<std::string>& abilities) {
+        auto [it, inserted] = abilityIds_.try_emplace(abilities, static_cast<int>(abilitySets_.size()));
+        if (inserted) abilitySets_.push_back(abilities);
+        return it->second;
+    }
+
+    std::deque<Archetype> archetypes_;
+    std::unordered_map<std::string, std::size_t> index_;
+    std::map<std::vector<std::string>, int> abilityIds_;
+    std::vector<std::vector<std::string>> abilitySets_;
+};
+
+// ====== Binary prototype registry ======
+// Prototypes can be shipped as a binary file built offline (writeRegistry) and
+// memory-mapped at startup. Names resolve through a minimal perfect hash stored
+// in the file, and the slot it yields is the prototype's ProtoId. All fields
+// are uint32/int32 written in host order, so every section is 4-byte aligned;
+// only little-endian hosts are supported, which makes the files little-endian.
+//
+//   RegistryHeader
+//   uint32_t       displacement[buckets]
+//   RegistryRecord records[count]      (record i is ProtoId i)
+//   RegistryString strings[stringCount]
+//   char           chars[]
+using ProtoId = std::uint32_t;
+
+enum class ProtoKind : std::uint32_t { Orc = 0, Dragon = 1 };
+
+struct RegistryHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t count;
+    std::uint32_t buckets;
+    std::uint32_t stringCount;
+    std::uint32_t charBytes;
+};
+
+struct RegistryRecord {
+    ProtoKind kind;
+    std::int32_t hp, atk;
+    std::uint32_t name;     // index into strings
+    std::uint32_t firstArg; // Orc: abilities, Dragon: element
+    std::uint32_t argCount;
+};
+
+struct RegistryString { std::uint32_t offset, length; };
+
+static_assert(std::endian::native == std::endian::little, "registry files are little-endian");
+
+// What writeRegistry takes: the same arguments registerProto would get
+struct ProtoSpec {
+    std::string name;
+    ProtoKind kind;
+    int hp, atk;
+    std::vector<std::string> args;
+};
+
+// Hash-and-displace minimal perfect hash: a key's bucket picks a displacement,
+// and (hash, displacement) picks its slot. The builder searches displacements
+// so every key lands in a distinct slot.
+struct PerfectHash {
+    static std::uint64_t hash(std::string_view s) { // FNV-1a
+        std::uint64_t h = 0xcbf29ce484222325ULL;
+        for (unsigned char c : s) { h ^= c; h *= 0x100000001b3ULL; }
+        return h;
+    }
+    static std::uint32_t bucket(std::uint64_t h, std::uint32_t buckets) {
+        return static_cast<std::uint32_t>(h % buckets);
+    }
+    static std::uint32_t slot(std::uint64_t h, std::uint32_t disp, std::uint32_t n) {
+        return static_cast<std::uint32_t>(CounterRng::mix(h ^ (disp * 0x9e3779b97f4a7c15ULL)) % n);
+    }
+};
+
+static void writeRegistry(const std::string& path, std::span<const ProtoSpec> specs) {
+    const auto n = static_cast<std::uint32_t>(specs.size());
+    const std::uint32_t buckets = std::max<std::uint32_t>(1, n / 4);
+
+    std::unordered_set<std::string_view> names;
+    for (const ProtoSpec& p : specs) {
+        if (!names.insert(p.name).second) throw std::runtime_error("duplicate prototype: " + p.name);
+        if (p.kind != ProtoKind::Orc && p.kind != ProtoKind::Dragon)
+            throw std::runtime_error("unknown prototype kind: " + p.name);
+    }
+
+    // Build the perfect hash: biggest buckets first, try displacements until
+    // all of a bucket's keys fall into free slots.
+    std::vector<std::uint64_t> hashes(n);
+    std::vector<std::vector<std::uint32_t>> members(buckets);
+    for (std::uint32_t i = 0; i < n; ++i) {
+        hashes[i] = PerfectHash::hash(specs[i].name);
+        members[PerfectHash::bucket(hashes[i], buckets)].push_back(i);
+    }
+    std::vector<std::uint32_t> order(buckets);
+    for (std::uint32_t b = 0; b < buckets; ++b) order[b] = b;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::uint32_t a, std::uint32_t b) { return members[a].size() > members[b].size(); });
+
+    std::vector<std::uint32_t> displacement(buckets, 0);
+    std::vector<std::int64_t> specAt(n, -1); // slot -> spec index
+    std::vector<std::uint32_t> tried;
+    for (std::uint32_t b : order) {
+        for (std::uint32_t d = 0;; ++d) {
+            if (d == 1u << 24) throw std::runtime_error("perfect hash: no displacement found");
+            tried.clear();
+            bool ok = true;
+            for (std::uint32_t i : members[b]) {
+                std::uint32_t s = PerfectHash::slot(hashes[i], d, n);
+                if (specAt[s] >= 0 || std::find(tried.begin(), tried.end(), s) != tried.end()) {
+                    ok = false;
+                    break;
+                }
+                tried.push_back(s);
+            }
+            if (!ok) continue;
+            for (std::size_t k = 0; k < members[b].size(); ++k) specAt[tried[k]] = members[b][k];
+            displacement[b] = d;
+            break;
+        }
+    }
+
+    // Lay out records in slot order, plus the string table
+    std::vector<RegistryRecord> records(n);
+    std::vector<RegistryString> strings;
+    std::string chars;
+    auto addString = [&](const std::string& s) {
+        strings.push_back({ static_cast<std::uint32_t>(chars.size()), static_cast<std::uint32_t>(s.size()) });
+        chars += s;
+        return static_cast<std::uint32_t>(strings.size() - 1);
+    };
+    for (std::uint32_t slot = 0; slot < n; ++slot) {
+        const ProtoSpec& p = specs[specAt[slot]];
+        RegistryRecord& r = records[slot];
+        r.kind = p.kind; r.hp = p.hp; r.atk = p.atk;
+        r.name = addString(p.name);
+        r.firstArg = static_cast<std::uint32_t>(strings.size());
+        r.argCount = static_cast<std::uint32_t>(p.args.size());
+        for (const auto& a : p.args) addString(a);
+    }
+
+    RegistryHeader h{ { 'E', 'R', 'E', 'G' }, 1, n, buckets,
+                      static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(chars.size()) };
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("cannot write registry: " + path);
+    out.write(reinterpret_cast<const char*>(&h), sizeof h);
+    out.write(reinterpret_cast<const char*>(displacement.data()), displacement.size() * sizeof(std::uint32_t));
+    out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(RegistryRecord));
+    out.write(reinterpret_cast<const char*>(strings.data()), strings.size() * sizeof(RegistryString));
+    out.write(chars.data(), static_cast<std::streamsize>(chars.size()));
+    if (!out) throw std::runtime_error("cannot write registry: " + path);
+}
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) throw std::runtime_error("cannot open: " + path);
+        LARGE_INTEGER size;
+        GetFileSizeEx(file_, &size);
+        size_ = static_cast<std::size_t>(size.QuadPart);
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_) data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        if (!data_) { close(); throw std::runtime_error("cannot map: " + path); }
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("cannot open: " + path);
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            size_ = static_cast<std::size_t>(st.st_size);
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) data_ = static_cast<const char*>(p);
+        }
+        ::close(fd);
+        if (!data_) throw std::runtime_error("cannot map: " + path);
+#endif
+    }
+
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    void close() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+        data_ = nullptr;
+    }
+
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// View over a mapped registry file; nothing is copied at load time. Every
+// record and string is bounds-checked once here, so lookups can trust them.
+class BinaryRegistry {
+public:
+    explicit BinaryRegistry(const std::string& path) : file_(path) {
+        const char* p = file_.data();
+        if (file_.size() < sizeof(RegistryHeader)) throw std::runtime_error("registry too small: " + path);
+        header_ = reinterpret_cast<const RegistryHeader*>(p);
+        if (std::memcmp(header_->magic, "EREG", 4) != 0 || header_->version != 1 || header_->buckets == 0)
+            throw std::runtime_error("bad registry: " + path);
+        std::uint64_t off = sizeof(RegistryHeader); // 64-bit so hostile counts cannot wrap
+        displacement_ = reinterpret_cast<const std::uint32_t*>(p + off);
+        off += std::uint64_t(header_->buckets) * sizeof(std::uint32_t);
+        const std::uint64_t recordsAt = off;
+        off += std::uint64_t(header_->count) * sizeof(RegistryRecord);
+        const std::uint64_t stringsAt = off;
+        off += std::uint64_t(header_->stringCount) * sizeof(RegistryString);
+        if (off + header_->charBytes > file_.size()) throw std::runtime_error("truncated registry: " + path);
+        records_ = reinterpret_cast<const RegistryRecord*>(p + recordsAt);
+        strings_ = reinterpret_cast<const RegistryString*>(p + stringsAt);
+        chars_ = p + off;
+        validate(path);
+    }
+
+    std::uint32_t size() const { return header_->count; }
+
+    std::optional<ProtoId> find(std::string_view name) const {
+        if (size() == 0) return std::nullopt;
+        const std::uint64_t h = PerfectHash::hash(name);
+        const ProtoId id = PerfectHash::slot(h, displacement_[PerfectHash::bucket(h, header_->buckets)], size());
+        if (this->name(id) != name) return std::nullopt; // not a key of this registry
+        return id;
+    }
+
+    std::string_view name(ProtoId id) const { return string(records_[id].name); }
+
+    std::unique_ptr<Enemy> makePrototype(ProtoId id) const {
+        const RegistryRecord& r = records_[id];
+        switch (r.kind) {
+        case ProtoKind::Dragon:
+            return std::make_unique<Dragon>(r.hp, r.atk, std::string(r.argCount ? string(r.firstArg) : "Fire"));
+        case ProtoKind::Orc: {
+            std::vector<std::string> abilities;
+            abilities.reserve(r.argCount);
+            for (std::uint32_t i = 0; i < r.argCount; ++i) abilities.emplace_back(string(r.firstArg + i));
+            return std::make_unique<Orc>(r.hp, r.atk, std::move(abilities));
+        }
+        }
+        throw std::runtime_error("unknown prototype kind " + std::to_string(std::uint32_t(r.kind)));
+    }
+
+private:
+    void validate(const std::string& path) const {
+        const std::uint32_t strings = header_->stringCount;
+        for (std::uint32_t i = 0; i < strings; ++i)
+            if (std::uint64_t(strings_[i].offset) + strings_[i].length > header_->charBytes)
+                throw std::runtime_error("bad registry string " + std::to_string(i) + ": " + path);
+        for (std::uint32_t i = 0; i < header_->count; ++i) {
+            const RegistryRecord& r = records_[i];
+            if (r.kind != ProtoKind::Orc && r.kind != ProtoKind::Dragon)
+                throw std::runtime_error("bad registry record " + std::to_string(i) + " (unknown kind): " + path);
+            if (r.name >= strings || std::uint64_t(r.firstArg) + r.argCount > strings)
+                throw std::runtime_error("bad registry record " + std::to_string(i) + " (string index): " + path);
+        }
+    }
+
+    std::string_view string(std::uint32_t i) const {
+        const RegistryString& s = strings_[i];
+        return std::string_view(chars_ + s.offset, s.length);
+    }
+
+    MappedFile file_;
+    const RegistryHeader* header_ = nullptr;
+    const std::uint32_t* displacement_ = nullptr;
+    const RegistryRecord* records_ = nullptr;
+    const RegistryString* strings_ = nullptr;
+    const char* chars_ = nullptr;
+};
+
+// ====== Worker threads for parallel spawning ======
+// Started once and parked between waves. run(task) calls task(0) on the
+// caller and task(1) ... task(size() - 1) on the workers, and returns when all
+// of them are done, rethrowing the first exception any of them threw.
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned size) : size_(std::max(1u, size)) {
+        for (unsigned w = 1; w < size_; ++w) threads_.emplace_back([this, w] { loop(w); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            quit_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned size() const { return size_; }
+
+    void run(const std::function<void(unsigned)>& task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            busy_ = size_ - 1;
+            error_ = nullptr;
+            ++generation_;
+        }
+        wake_.notify_all();
+        call(task, 0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return busy_ == 0; });
+        if (error_) std::rethrow_exception(error_);
+    }
+
+private:
+    void loop(unsigned w) {
+        std::uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(unsigned)>* task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return quit_ || generation_ != seen; });
+                if (quit_) return;
+                seen = generation_;
+                task = task_;
+            }
+            call(*task, w);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--busy_ == 0) done_.notify_one();
+        }
+    }
+
+    void call(const std::function<void(unsigned)>& task, unsigned w) {
+        try { task(w); }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+    }
+
+    const unsigned size_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_, done_;
+    const std::function<void(unsigned)>* task_ = nullptr;
+    unsigned busy_ = 0;
+    std::uint64_t generation_ = 0;
+    std::exception_ptr error_;
+    bool quit_ = false;
 };
 
 // ====== Prototype Registry / Spawner ======
+// Prototypes live in a vector indexed by ProtoId. Resolve a name once with
+// resolve(), then spawn by id: no string hashing on the hot path.
 class EnemySpawner {
 public:
     template<class T, class...Args>
-    void registerProto(const std::string& key, Args&&...args) {
-        protos_[key] = std::unique_ptr<Enemy>(new T(std::forward<Args>(args)...));
+    ProtoId registerProto(const std::string& key, Args&&...args) {
+        return add(key, std::unique_ptr<Enemy>(new T(std::forward<Args>(args)...)));
     }
 
-    std::unique_ptr<Enemy> spawn(const std::string& key, int x, int y) const {
-        auto it = protos_.find(key);
-        if (it == protos_.end()) throw std::runtime_error("no prototype: " + key);
-        auto e = it->second->clone();
+    // Append every prototype of a mapped registry file. Their names resolve
+    // through the file's perfect hash; ids are offset by what was already here.
+    // Nothing is built until an id is first used, so loading is just the mapping.
+    // Loaded prototypes are not added to world(); use addArchetype(name, prototype(id)).
+    // A name that is also registered in code resolves to the in-code prototype.
+    void loadRegistry(const std::string& path) {
+        auto reg = std::make_unique<BinaryRegistry>(path);
+        const auto base = static_cast<ProtoId>(protos_.size());
+        protos_.resize(base + reg->size());
+        pools_.resize(protos_.size());
+        for (ProtoId i = 0; i < reg->size(); ++i) ready_.emplace_back();
+        registries_.push_back({ base, std::move(reg) });
+    }
+
+    const Enemy& prototype(ProtoId id) const {
+        if (id >= protos_.size()) throw std::runtime_error("no prototype id: " + std::to_string(id));
+        std::call_once(ready_[id], [&] {
+            if (protos_[id]) return;
+            for (const auto& r : registries_)
+                if (id - r.base < r.file->size()) { protos_[id] = r.file->makePrototype(id - r.base); return; }
+        });
+        return *protos_[id];
+    }
+
+    // In-code registrations win over mapped registries, whatever the order they
+    // came in, so registerProto() can override a shipped prototype. Between
+    // registries, the one loaded first wins.
+    ProtoId resolve(const std::string& key) const {
+        if (auto it = ids_.find(key); it != ids_.end()) return it->second;
+        for (const auto& r : registries_)
+            if (auto id = r.file->find(key)) return r.base + *id;
+        throw std::runtime_error("no prototype: " + key);
+    }
+
+    // Data-oriented backend: one archetype per registered prototype
+    EnemyWorld& world() { return world_; }
+
+    std::unique_ptr<Enemy> spawn(ProtoId id, int x, int y) const {
+        auto e = prototype(id).clone();
         e->spawnAt(x, y);
         return e;
     }
 
+    std::unique_ptr<Enemy> spawn(const std::string& key, int x, int y) const {
+        return spawn(resolve(key), x, y);
+    }
+
+    // Bulk spawn from the prototype's pool: one enemy per position.
+    std::vector<PooledEnemy> spawnN(ProtoId id, std::span<const Position> at) {
+        EnemyPool& pool = poolFor(id);
+        std::vector<PooledEnemy> out;
+        out.reserve(at.size());
+        for (const auto& p : at) out.push_back(pool.acquire(p.x, p.y));
+        return out;
+    }
+
+    std::vector<PooledEnemy> spawnN(const std::string& key, std::span<const Position> at) {
+        return spawnN(resolve(key), at);
+    }
+
+    // Spawn `count` enemies at random spots within +-radius, split across threads.
+    // Enemy i always gets id base+i and a position drawn from counter i of the
+    // seed's stream, so the same seed gives the same wave for any thread count.
+    // Workers are kept between calls. Each one resets and clones from its own
+    // copy of the prototype (see EnemyPool::workerPrototypes) and stores its new
+    // enemies and handles straight into presized slots.
+    std::vector<PooledEnemy> spawnWave(ProtoId id, std::size_t count, int radius,
+                                       std::uint64_t seed, unsigned threads) {
+        EnemyPool& pool = poolFor(id);
+        const CounterRng rand{ seed, 0 };
+        const int base = Ids.reserve(static_cast<int>(count));
+
+        std::vector<Enemy*> slots(count);
+        const std::size_t reused = pool.takeFree(slots);
+        const std::size_t first = pool.grow(count - reused); // storage for enemies [reused, count)
+        std::vector<PooledEnemy> out(count);
+
+        threads = std::max(1u, threads);
+        if (!workers_ || workers_->size() != threads) {
+            workers_.reset(); // join the old threads before starting new ones
+            workers_ = std::make_unique<WorkerPool>(threads);
+        }
+        const auto protos = pool.workerPrototypes(threads);
+        const std::size_t per = (count + threads - 1) / threads;
+        const std::function<void(unsigned)> work = [&](unsigned w) {
+            const std::size_t lo = std::min(count, w * per), hi = std::min(count, lo + per);
+            if (lo == hi) return;
+            const Enemy& local = *protos[w];
+            for (std::size_t i = lo; i < hi; ++i) {
+                Enemy* e = slots[i];
+                if (i < reused) e->resetFrom(local);
+                else e = pool.fill(first + (i - reused), local.clone());
+                out[i] = pool.handle(e);
+                e->spawnAt(rand.range(2 * i, -radius, radius),
+                           rand.range(2 * i + 1, -radius, radius),
+                           base + static_cast<int>(i));
+            }
+        };
+        try { workers_->run(work); }
+        catch (...) {
+            // Hand every taken enemy back via `out`, drop the slots nobody filled
+            for (std::size_t i = 0; i < reused; ++i)
+                if (!out[i]) out[i] = pool.handle(slots[i]);
+            pool.trimEmpty(first);
+            throw;
+        }
+        return out;
+    }
+
+    std::vector<PooledEnemy> spawnWave(const std::string& key, std::size_t count, int radius,
+                                       std::uint64_t seed, unsigned threads) {
+        return spawnWave(resolve(key), count, radius, seed, threads);
+    }
+
 private:
-    std::unordered_map<std::string, std::unique_ptr<Enemy>> protos_;
+    struct LoadedRegistry {
+        ProtoId base;
+        std::unique_ptr<BinaryRegistry> file;
+    };
+
+    ProtoId add(const std::string& key, std::unique_ptr<Enemy> proto) {
+        if (auto it = ids_.find(key); it != ids_.end() && pools_[it->second] && pools_[it->second]->outstanding())
+            throw std::runtime_error("prototype in use, cannot re-register: " + key);
+        world_.addArchetype(key, *proto);
+        auto [it, inserted] = ids_.try_emplace(key, static_cast<ProtoId>(protos_.size()));
+        if (inserted) {
+            protos_.push_back(std::move(proto));
+            pools_.emplace_back();
+            ready_.emplace_back();
+        }
+        else {
+            protos_[it->second] = std::move(proto);
+            pools_[it->second].reset(); // pool refers to the old prototype
+        }
+        return it->second;
+    }
+
+    EnemyPool& poolFor(ProtoId id) {
+        const Enemy& proto = prototype(id);
+        auto& pool = pools_[id];
+        if (!pool) pool = std::make_unique<EnemyPool>(proto);
+        return *pool;
+    }
+
+    mutable std::vector<std::unique_ptr<Enemy>> protos_; // null until first use for loaded registries
+    mutable std::deque<std::once_flag> ready_;
+    std::vector<std::unique_ptr<EnemyPool>> pools_;
+    std::unordered_map<std::string, ProtoId> ids_;
+    std::vector<LoadedRegistry> registries_;
+    EnemyWorld world_;
+    std::unique_ptr<WorkerPool> workers_; // spawnWave() threads, kept between waves
 };
 
+// ====== Benchmark ======
+static void runBenchmark() {
+    using Clock = std::chrono::steady_clock;
+    const int waveSize = 100000;
+    const int waves = 20;
+
+    EnemySpawner spawner;
+    spawner.registerProto<Orc>("orc-basic", 120, 15, std::vector<std::string>{"Roar", "Charge"});
+
+    std::vector<Position> at(waveSize);
+    for (auto& p : at) p = { rand_range(-500, 500), rand_range(-500, 500) };
+
+    auto report = [&](const char* label, Clock::duration t, std::size_t allocs) {
+        double secs = std::chrono::duration<double>(t).count();
+        std::cout << label << ": " << std::fixed << std::setprecision(1)
+            << waves / secs << " waves/s, " << double(allocs) / waves << " allocs/wave\n";
+    };
+
+    // Clone cost and per-enemy memory
+    {
+        const int clones = 1000000;
+        auto proto = spawner.spawn("orc-basic", 0, 0);
+        std::vector<std::unique_ptr<Enemy>> keep(clones);
+        auto a0 = AllocCount.load(); auto b0 = AllocBytes.load();
+        auto t0 = Clock::now();
+        for (auto& k : keep) k = proto->clone();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / clones;
+        std::cout << "clone(): " << std::fixed << std::setprecision(1) << ns << " ns, "
+            << double(AllocCount.load() - a0) / clones << " allocs, "
+            << double(AllocBytes.load() - b0) / clones << " heap bytes per clone (sizeof(Orc)="
+            << sizeof(Orc) << ")\n\n";
+    }
+
+    std::cout << "Wave of " << waveSize << " orcs, " << waves << " waves\n";
+    {
+        auto a0 = AllocCount.load();
+        auto t0 = Clock::now();
+        for (int w = 0; w < waves; ++w) {
+            std::vector<std::unique_ptr<Enemy>> wave;
+            wave.reserve(at.size());
+            for (const auto& p : at) wave.push_back(spawner.spawn("orc-basic", p.x, p.y));
+        }
+        report("spawn() x N  ", Clock::now() - t0, AllocCount.load() - a0);
+    }
+    {
+        spawner.spawnN("orc-basic", at); // warm the pool
+        auto a0 = AllocCount.load();
+        auto t0 = Clock::now();
+        for (int w = 0; w < waves; ++w) {
+            auto wave = spawner.spawnN("orc-basic", at);
+        }
+        report("spawnN() pool", Clock::now() - t0, AllocCount.load() - a0);
+    }
+
+    // Parallel waves: same seed must give the same wave for every thread count
+    auto checksum = [](const std::vector<PooledEnemy>& wave) {
+        std::uint64_t h = 0;
+        for (const auto& e : wave)
+            h = CounterRng::mix(h ^ (std::uint64_t(e->id() - wave[0]->id()) << 40)
+                                  ^ (std::uint64_t(std::uint32_t(e->x())) << 20) ^ std::uint32_t(e->y()));
+        return h;
+    };
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= std::max(8u, hw); threads *= 2) {
+        spawner.spawnWave("orc-basic", waveSize, 500, 42, threads); // warm
+        std::uint64_t h = 0;
+        auto t0 = Clock::now();
+        for (int w = 0; w < waves; ++w) {
+            auto wave = spawner.spawnWave("orc-basic", waveSize, 500, 42, threads);
+            h = checksum(wave);
+        }
+        double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+        std::cout << "spawnWave() " << threads << " thread(s): " << std::fixed << std::setprecision(1)
+            << waves / secs << " waves/s, checksum " << std::hex << h << std::dec << "\n";
+    }
+
+    // Per-tick update: pointer-based wave vs archetype columns
+    const std::size_t population = 1000000;
+    const int ticks = 20;
+    std::cout << "\nTick " << population << " orcs x " << ticks << " ticks\n";
+    auto tickReport = [&](const char* label, Clock::duration t, long long sum) {
+        double ns = std::chrono::duration<double, std::nano>(t).count() / (double(population) * ticks);
+        std::cout << label << ": " << std::fixed << std::setprecision(2) << ns
+            << " ns/enemy/tick, checksum " << sum << "\n";
+    };
+    {
+        auto wave = spawner.spawnWave("orc-basic", population, 500, 42, 1);
+        auto t0 = Clock::now();
+        for (int t = 0; t < ticks; ++t)
+            for (auto& e : wave) e->tick();
+        auto dt = Clock::now() - t0;
+        long long sum = 0;
+        for (auto& e : wave) sum += e->x() + e->y() + e->components().hp;
+        tickReport("unique_ptr<Enemy> wave", dt, sum);
+    }
+    {
+        std::vector<Position> spots(population);
+        const CounterRng rand{ 42, 0 };
+        for (std::size_t i = 0; i < population; ++i)
+            spots[i] = { rand.range(2 * i, -500, 500), rand.range(2 * i + 1, -500, 500) };
+        EnemyWorld& world = spawner.world();
+        Archetype& orcs = world.spawnN("orc-basic", spots);
+        auto t0 = Clock::now();
+        for (int t = 0; t < ticks; ++t) world.tick();
+        auto dt = Clock::now() - t0;
+        long long sum = 0;
+        for (std::size_t i = 0; i < orcs.size(); ++i) sum += orcs.x[i] + orcs.y[i] + orcs.hp[i];
+        tickReport("archetype columns     ", dt, sum);
+        orcs.clear();
+    }
+
+    // Startup: thousands of prototypes registered in code vs loaded from a mapped file
+    const int protoCount = 5000;
+    std::vector<ProtoSpec> specs;
+    for (int i = 0; i < protoCount; ++i) {
+        if (i % 2) specs.push_back({ "dragon-" + std::to_string(i), ProtoKind::Dragon, 300 + i % 50, 35, { "Ice" } });
+        else specs.push_back({ "orc-" + std::to_string(i), ProtoKind::Orc, 100 + i % 50, 12, { "Roar", "Charge" } });
+    }
+    const std::string path = (std::filesystem::temp_directory_path() / "enemy_bench.reg").string();
+    writeRegistry(path, specs);
+
+    std::cout << "\nRegistry of " << protoCount << " prototypes\n";
+    EnemySpawner fromCode, fromFile;
+    {
+        auto t0 = Clock::now();
+        for (const auto& p : specs) {
+            if (p.kind == ProtoKind::Dragon) fromCode.registerProto<Dragon>(p.name, p.hp, p.atk, p.args[0]);
+            else fromCode.registerProto<Orc>(p.name, p.hp, p.atk, p.args);
+        }
+        std::cout << "registerProto() x " << protoCount << ": "
+            << std::chrono::duration<double, std::milli>(Clock::now() - t0).count() << " ms\n";
+    }
+    {
+        auto t0 = Clock::now();
+        fromFile.loadRegistry(path);
+        auto t1 = Clock::now();
+        // registerProto() also builds every prototype and its archetype; do the same here
+        for (const auto& p : specs) fromFile.world().addArchetype(p.name, fromFile.prototype(fromFile.resolve(p.name)));
+        auto t2 = Clock::now();
+        std::cout << "loadRegistry() mapped   : "
+            << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, + building all "
+            << protoCount << " prototypes and archetypes: "
+            << std::chrono::duration<double, std::milli>(t2 - t0).count() << " ms\n";
+    }
+    {
+        const int spawns = 1000000;
+        const std::string key = "orc-1234";
+        const ProtoId id = fromFile.resolve(key);
+        auto time = [&](auto&& spawnOne) {
+            auto t0 = Clock::now();
+            for (int i = 0; i < spawns; ++i) spawnOne();
+            return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / spawns;
+        };
+        double byKey = time([&] { auto e = fromCode.spawn(key, 0, 0); });
+        double byId = time([&] { auto e = fromFile.spawn(id, 0, 0); });
+        std::cout << "spawn(string): " << byKey << " ns, spawn(ProtoId): " << byId << " ns\n";
+    }
+    std::filesystem::remove(path);
+}
+
 // ====== Demo ======
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        runBenchmark();
+        return 0;
+    }
+
     EnemySpawner spawner;
 
     // Register base enemy prototypes (expensive setup could happen here once)
@@ -145,5 +1211,52 @@ int main() {
     protoOrc->info();
     protoDragon->info();
 
+    // Bulk spawn from the pool; handles go back to the pool when the wave ends
+    std::cout << "\n=== Pooled wave ===\n";
+    const Position spots[] = { {1, 1}, {2, 2}, {3, 3} };
+    {
+        auto pooled = spawner.spawnN("orc-basic", spots);
+        static_cast<Orc*>(pooled[0].get())->addAbility("Berserk");
+        for (auto& e : pooled) e->info();
+    }
+    for (auto& e : spawner.spawnN("orc-basic", spots)) e->info(); // recycled, reset to prototype
+
+    // Parallel spawn: reproducible from the seed, whatever the thread count
+    std::cout << "\n=== Parallel wave (seed 7) ===\n";
+    for (auto& e : spawner.spawnWave("orc-basic", 4, 5, 7, 2)) e->info();
+
+    // Same prototypes as data-oriented archetype rows
+    std::cout << "\n=== Archetype rows ===\n";
+    EnemyWorld& world = spawner.world();
+    Archetype& orcs = world.spawnN("orc-basic", spots);
+    Archetype& dragons = world.spawnN("dragon-fire", std::span(spots, 1));
+    world.tick();
+    for (std::size_t i = 0; i < orcs.size(); ++i) world.info(orcs, i);
+    world.info(dragons, 0);
+
+    // Prototypes shipped as a binary registry, spawned by pre-resolved id
+    std::cout << "\n=== Binary registry ===\n";
+    const ProtoSpec specs[] = {
+        { "orc-elite", ProtoKind::Orc, 200, 25, { "Roar", "Shield Bash" } },
+        { "dragon-ice", ProtoKind::Dragon, 400, 45, { "Ice" } },
+        { "orc-scout", ProtoKind::Orc, 80, 10, { "Sprint" } },
+    };
+    const std::string path = (std::filesystem::temp_directory_path() / "enemy_demo.reg").string();
+    writeRegistry(path, specs);
+    {
+        EnemySpawner shipped;
+        shipped.loadRegistry(path);
+        const ProtoId elite = shipped.resolve("orc-elite"); // resolve once...
+        for (int i = 0; i < 2; ++i) shipped.spawn(elite, i, i)->info(); // ...spawn by id
+        shipped.spawn("dragon-ice", 9, 9)->info();
+
+        // Registering a shipped name in code overrides the file's prototype
+        shipped.registerProto<Orc>("orc-scout", 90, 12, std::vector<std::string>{"Sprint", "Ambush"});
+        const Enemy& scout = shipped.prototype(shipped.resolve("orc-scout"));
+        if (scout.components().hp != 90) throw std::runtime_error("in-code orc-scout was shadowed");
+        shipped.spawn("orc-scout", 3, 3)->info();
+    }
+    std::filesystem::remove(path);
+
     return 0;
 }
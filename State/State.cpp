@@ -1,5 +1,756 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAS_TSC 1
+#endif
+
+// Counts heap allocations so the benchmark can show transitions don't allocate.
+// The cache-line aligned ring and shards come from the aligned forms, so
+// those are replaced (and counted) along with the nothrow and array ones.
+static std::atomic<std::size_t> AllocCount{ 0 };
+
+static void* countedAlloc(std::size_t n, std::size_t align) noexcept
+{
+    AllocCount.fetch_add(1, std::memory_order_relaxed);
+    if (n == 0) n = 1;
+    if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) return std::malloc(n);
+#ifdef _WIN32
+    return _aligned_malloc(n, align);
+#else
+    return std::aligned_alloc(align, (n + align - 1) / align * align);
+#endif
+}
+// Must stay out of line, or GCC warns that free() doesn't match operator new
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+static void countedFree(void* p, std::size_t align) noexcept
+{
+#ifdef _WIN32
+    if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) return _aligned_free(p);
+#endif
+    (void)align;
+    std::free(p);
+}
+
+void* operator new(std::size_t n)
+{
+    if (void* p = countedAlloc(n, 0)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t n, std::align_val_t a)
+{
+    if (void* p = countedAlloc(n, std::size_t(a))) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t n) { return ::operator new(n); }
+void* operator new[](std::size_t n, std::align_val_t a) { return ::operator new(n, a); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n, 0); }
+void* operator new(std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return countedAlloc(n, std::size_t(a)); }
+void* operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return countedAlloc(n, std::size_t(a)); }
+void operator delete(void* p) noexcept { countedFree(p, 0); }
+void operator delete[](void* p) noexcept { countedFree(p, 0); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p, 0); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p, 0); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p, 0); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p, 0); }
+void operator delete(void* p, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete[](void* p, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete(void* p, std::size_t, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete[](void* p, std::size_t, std::align_val_t a) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete(void* p, std::align_val_t a, const std::nothrow_t&) noexcept { countedFree(p, std::size_t(a)); }
+void operator delete[](void* p, std::align_val_t a, const std::nothrow_t&) noexcept { countedFree(p, std::size_t(a)); }
+
+// =======================
+// Audio pipeline
+// =======================
+// What PlayingState actually drives. A decoder thread renders fixed-size
+// periods into a lock-free single-producer/single-consumer ring. A sink
+// thread, paced like a sound card, takes one period per period time and
+// hands it to a PcmSink. Commands only flip atomics, and the sink applies
+// them at its next period boundary, so output is always whole periods.
+constexpr std::size_t kSampleRate = 48000;
+constexpr std::size_t kChannels = 2;
+constexpr std::size_t kPeriodFrames = 256;
+constexpr std::chrono::nanoseconds kPeriodTime{ 1'000'000'000ull * kPeriodFrames / kSampleRate };
+
+struct Period
+{
+    std::array<std::int16_t, kPeriodFrames * kChannels> samples;
+    std::chrono::steady_clock::time_point rendered;
+    std::int64_t pausedNsAtRender; // so latency can leave out time spent paused
+    std::uint32_t generation; // stop() bumps the pipeline's; older periods are dropped
+};
+
+// Slots are filled and drained in place: beginWrite/commitWrite on the
+// producer thread, beginRead/commitRead on the consumer thread.
+template <class T, std::size_t Capacity>
+class SpscRing
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // nullptr when full
+    T* beginWrite()
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == Capacity) return nullptr;
+        return &slots[h & (Capacity - 1)];
+    }
+
+    void commitWrite()
+    {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // nullptr when empty
+    const T* beginRead()
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (head.load(std::memory_order_acquire) == t) return nullptr;
+        return &slots[t & (Capacity - 1)];
+    }
+
+    void commitRead()
+    {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    std::size_t size() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<std::size_t> head{ 0 };
+    alignas(64) std::atomic<std::size_t> tail{ 0 };
+    alignas(64) std::array<T, Capacity> slots;
+};
+
+// Where finished periods go. Called on the sink thread only.
+class PcmSink
+{
+public:
+    virtual ~PcmSink() = default;
+    virtual void write(std::span<const std::int16_t> samples) = 0;
+};
+
+// Discards audio; for running without sound hardware
+class NullSink final : public PcmSink
+{
+public:
+    void write(std::span<const std::int16_t> samples) override
+    {
+        written += samples.size();
+    }
+
+    std::uint64_t samples() const { return written; }
+
+private:
+    std::uint64_t written = 0;
+};
+
+// 16-bit PCM WAV file; the header sizes are filled in when the sink closes.
+// The RIFF sizes are 32-bit, so a file holds just under 4 GiB of samples:
+// past that the sink stops writing, full() turns true, and the file stays valid.
+class WavSink final : public PcmSink
+{
+public:
+    explicit WavSink(const std::string& path)
+        : file(path, std::ios::binary)
+    {
+        if (!file)
+        {
+            throw std::runtime_error("WavSink: cannot write " + path);
+        }
+        writeHeader(0);
+    }
+
+    ~WavSink() override
+    {
+        file.seekp(0);
+        writeHeader(dataBytes);
+    }
+
+    // One stream write per period; samples are byte-swapped first on big-endian hosts
+    void write(std::span<const std::int16_t> samples) override
+    {
+        const std::size_t room = (kMaxDataBytes - dataBytes) / 2;
+        if (samples.size() > room)
+        {
+            samples = samples.first(room / kChannels * kChannels);
+            isFull = true;
+        }
+        const char* bytes = reinterpret_cast<const char*>(samples.data());
+        if constexpr (std::endian::native == std::endian::big)
+        {
+            swapped.resize(samples.size());
+            std::transform(samples.begin(), samples.end(), swapped.begin(), [](std::int16_t v)
+            {
+                const auto u = static_cast<std::uint16_t>(v);
+                return static_cast<std::int16_t>(static_cast<std::uint16_t>(u << 8 | u >> 8));
+            });
+            bytes = reinterpret_cast<const char*>(swapped.data());
+        }
+        file.write(bytes, static_cast<std::streamsize>(samples.size() * 2));
+        dataBytes += static_cast<std::uint32_t>(samples.size() * 2);
+    }
+
+    bool full() const { return isFull; }
+
+private:
+    // Largest data chunk whose RIFF size (36 + data) still fits, in whole frames
+    static constexpr std::uint32_t kMaxDataBytes = (0xffffffffu - 36) / (kChannels * 2) * (kChannels * 2);
+
+    void put(std::uint32_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i) file.put(static_cast<char>((value >> (8 * i)) & 0xff)); // little-endian
+    }
+
+    void writeHeader(std::uint32_t dataSize)
+    {
+        file.write("RIFF", 4);
+        put(36 + dataSize, 4);
+        file.write("WAVEfmt ", 8);
+        put(16, 4);                                 // fmt chunk size
+        put(1, 2);                                  // PCM
+        put(kChannels, 2);
+        put(kSampleRate, 4);
+        put(kSampleRate * kChannels * 2, 4);        // byte rate
+        put(kChannels * 2, 2);                      // block align
+        put(16, 2);                                 // bits per sample
+        file.write("data", 4);
+        put(dataSize, 4);
+    }
+
+    std::ofstream file;
+    std::uint32_t dataBytes = 0;
+    bool isFull = false;
+    std::vector<std::int16_t> swapped; // big-endian hosts only
+};
+
+struct PipelineStats
+{
+    std::uint64_t periodsPlayed = 0;  // audio periods delivered to the sink
+    std::uint64_t silentPeriods = 0;  // paused or stopped
+    std::uint64_t underruns = 0;      // playing, but the decoder had nothing ready
+    std::uint64_t dropped = 0;        // rendered before a stop(), never played
+    double avgLatencyMs = 0;          // rendered -> handed to the sink, excluding pauses
+    double maxLatencyMs = 0;
+    double maxCommandDelayMs = 0;     // play/pause/stop call -> first period reflecting it
+};
+
+class AudioPipeline
+{
+public:
+    // leadPeriods: how far ahead of the sink the decoder renders
+    explicit AudioPipeline(PcmSink& sink, std::size_t leadPeriods = 4)
+        : sink(sink)
+        , lead(std::clamp<std::size_t>(leadPeriods, 1, kRingPeriods))
+        , decoder([this] { decodeLoop(); })
+        , output([this] { sinkLoop(); })
+    {
+    }
+
+    ~AudioPipeline()
+    {
+        quit = true;
+        decoder.join();
+        output.join();
+    }
+
+    AudioPipeline(const AudioPipeline&) = delete;
+    AudioPipeline& operator=(const AudioPipeline&) = delete;
+
+    // Resumes from where pause() left off
+    void play() { command(Mode::Playing); }
+
+    // Keeps whatever is buffered for resume
+    void pause() { command(Mode::Paused); }
+
+    // Drops buffered audio and rewinds the decoder
+    void stop()
+    {
+        ++generation;
+        command(Mode::Stopped);
+    }
+
+    PipelineStats stats() const
+    {
+        PipelineStats s;
+        s.periodsPlayed = periodsPlayed.load();
+        s.silentPeriods = silentPeriods.load();
+        s.underruns = underruns.load();
+        s.dropped = dropped.load();
+        s.avgLatencyMs = s.periodsPlayed ? double(latencyNsSum.load()) / s.periodsPlayed / 1e6 : 0;
+        s.maxLatencyMs = double(latencyNsMax.load()) / 1e6;
+        s.maxCommandDelayMs = double(commandDelayNsMax.load()) / 1e6;
+        return s;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    enum class Mode : std::uint8_t { Stopped, Playing, Paused };
+    static constexpr std::size_t kRingPeriods = 16;
+
+    static std::int64_t nowNs()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    static void raiseMax(std::atomic<std::int64_t>& max, std::int64_t value)
+    {
+        std::int64_t seen = max.load(std::memory_order_relaxed);
+        while (value > seen && !max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+    }
+
+    void command(Mode m)
+    {
+        mode = m;
+        std::int64_t none = 0;
+        commandAt.compare_exchange_strong(none, nowNs()); // keep the oldest unapplied request
+    }
+
+    // Two mixed sine tones, 440 Hz and 660 Hz
+    void decodeLoop()
+    {
+        std::uint64_t frame = 0;
+        std::uint32_t seenGeneration = generation;
+        while (!quit)
+        {
+            if (generation != seenGeneration)
+            {
+                seenGeneration = generation;
+                frame = 0;
+            }
+            Period* p = mode == Mode::Playing && ring.size() < lead ? ring.beginWrite() : nullptr;
+            if (!p)
+            {
+                std::this_thread::sleep_for(kPeriodTime / 4);
+                continue;
+            }
+            for (std::size_t i = 0; i < kPeriodFrames; ++i, ++frame)
+            {
+                const double t = double(frame) / kSampleRate;
+                const double v = 0.3 * std::sin(2 * kPi * 440 * t) + 0.2 * std::sin(2 * kPi * 660 * t);
+                const auto sample = static_cast<std::int16_t>(v * 32767);
+                for (std::size_t c = 0; c < kChannels; ++c) p->samples[i * kChannels + c] = sample;
+            }
+            p->generation = seenGeneration;
+            p->pausedNsAtRender = pausedNs.load();
+            p->rendered = Clock::now();
+            ring.commitWrite();
+        }
+    }
+
+    void sinkLoop()
+    {
+        static const std::array<std::int16_t, kPeriodFrames * kChannels> silence{};
+        auto deadline = Clock::now();
+        while (!quit)
+        {
+            deadline += kPeriodTime;
+            std::this_thread::sleep_until(deadline);
+
+            const std::int64_t requested = commandAt.exchange(0);
+            if (requested != 0) raiseMax(commandDelayNsMax, nowNs() - requested);
+
+            const Period* p = ring.beginRead();
+            while (p && p->generation != generation)
+            {
+                ring.commitRead();
+                ++dropped;
+                p = ring.beginRead();
+            }
+
+            const Mode m = mode;
+            if (m != Mode::Playing)
+            {
+                sink.write(silence);
+                ++silentPeriods;
+                if (m == Mode::Paused) pausedNs += kPeriodTime.count();
+                continue;
+            }
+            if (!p)
+            {
+                sink.write(silence);
+                ++underruns;
+                continue;
+            }
+            const std::int64_t latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - p->rendered).count()
+                - (pausedNs.load() - p->pausedNsAtRender);
+            sink.write(p->samples);
+            ring.commitRead();
+            ++periodsPlayed;
+            latencyNsSum += latency;
+            raiseMax(latencyNsMax, latency);
+        }
+    }
+
+    static constexpr double kPi = 3.14159265358979323846;
+
+    PcmSink& sink;
+    const std::size_t lead;
+    SpscRing<Period, kRingPeriods> ring;
+    std::atomic<Mode> mode{ Mode::Stopped };
+    std::atomic<std::uint32_t> generation{ 0 };
+    std::atomic<std::int64_t> commandAt{ 0 };
+    std::atomic<std::int64_t> pausedNs{ 0 };
+    std::atomic<bool> quit{ false };
+    std::atomic<std::uint64_t> periodsPlayed{ 0 }, silentPeriods{ 0 }, underruns{ 0 }, dropped{ 0 };
+    std::atomic<std::int64_t> latencyNsSum{ 0 }, latencyNsMax{ 0 }, commandDelayNsMax{ 0 };
+    std::thread decoder; // last: started after everything above exists
+    std::thread output;
+};
+
+// =======================
+// States and events
+// =======================
+enum class PlayerState : std::uint8_t { Stopped, Playing, Paused, Count };
+enum class PlayerEvent : std::uint8_t { Play, Pause, Stop, Count };
+
+constexpr std::size_t kStateCount = static_cast<std::size_t>(PlayerState::Count);
+constexpr std::size_t kEventCount = static_cast<std::size_t>(PlayerEvent::Count);
+
+constexpr const char* stateName(PlayerState s)
+{
+    constexpr const char* names[] = { "Stopped", "Playing", "Paused" };
+    return names[static_cast<std::size_t>(s)];
+}
+
+constexpr const char* eventName(PlayerEvent e)
+{
+    constexpr const char* names[] = { "play", "pause", "stop" };
+    return names[static_cast<std::size_t>(e)];
+}
+
+constexpr const char* commandLine(PlayerEvent e)
+{
+    constexpr const char* lines[] = { "Command: play()\n", "Command: pause()\n", "Command: stop()\n" };
+    return lines[static_cast<std::size_t>(e)];
+}
+
+// =======================
+// Telemetry
+// =======================
+// Transition counts per (from, event, to), rejected events per (state, event),
+// and time-in-state histograms. Every thread records into its own shard with
+// plain relaxed stores, so no locked instructions and no shared cache lines;
+// snapshot() sums the shards. Shards outlive their threads, so nothing
+// recorded is lost when a thread exits.
+
+// Timestamps for time-in-state. steady_clock::now() was most of the cost of
+// a recorded transition; the TSC reads in a few cycles and runs at a constant
+// rate on current x86 parts. Ticks become ns through a ratio measured once
+// against steady_clock. Without a TSC, ticks are steady_clock nanoseconds.
+struct TelemetryClock
+{
+    static std::uint64_t now()
+    {
+#ifdef HAS_TSC
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Measured on the first call, which spins for about 2 ms
+    static double nsPerTick()
+    {
+#ifdef HAS_TSC
+        static const double ratio = []
+        {
+            using Steady = std::chrono::steady_clock;
+            const auto t0 = Steady::now();
+            const std::uint64_t c0 = now();
+            while (Steady::now() - t0 < std::chrono::milliseconds(2)) {}
+            const auto t1 = Steady::now();
+            const std::uint64_t c1 = now();
+            return std::chrono::duration<double, std::nano>(t1 - t0).count() / double(c1 - c0);
+        }();
+        return ratio;
+#else
+        return 1.0;
+#endif
+    }
+};
+
+struct TelemetrySnapshot
+{
+    static constexpr std::size_t kBuckets = 40; // bucket k: [2^k, 2^(k+1)) ns
+
+    std::uint64_t transitions[kStateCount][kEventCount][kStateCount] = {};
+    std::uint64_t rejected[kStateCount][kEventCount] = {};
+    std::uint64_t timeInState[kStateCount][kBuckets] = {};
+    std::uint64_t nsInState[kStateCount] = {};
+
+    void writeText(std::ostream& os) const
+    {
+        os << "transitions\n";
+        for (std::size_t f = 0; f < kStateCount; ++f)
+            for (std::size_t e = 0; e < kEventCount; ++e)
+                for (std::size_t t = 0; t < kStateCount; ++t)
+                {
+                    if (transitions[f][e][t] == 0) continue;
+                    os << "  " << stateName(PlayerState(f)) << " --" << eventName(PlayerEvent(e)) << "--> "
+                        << stateName(PlayerState(t)) << ' ' << transitions[f][e][t] << '\n';
+                }
+        os << "rejected\n";
+        for (std::size_t s = 0; s < kStateCount; ++s)
+            for (std::size_t e = 0; e < kEventCount; ++e)
+            {
+                if (rejected[s][e] == 0) continue;
+                os << "  " << eventName(PlayerEvent(e)) << " while " << stateName(PlayerState(s)) << ' ' << rejected[s][e] << '\n';
+            }
+        os << "time in state (completed visits)\n";
+        for (std::size_t s = 0; s < kStateCount; ++s)
+        {
+            std::uint64_t visits = 0;
+            for (std::uint64_t n : timeInState[s]) visits += n;
+            if (visits == 0) continue;
+            os << "  " << stateName(PlayerState(s)) << ": " << visits << " visits, mean "
+                << double(nsInState[s]) / visits << " ns\n";
+            for (std::size_t b = 0; b < kBuckets; ++b)
+            {
+                if (timeInState[s][b] == 0) continue;
+                os << "    [2^" << b << ", 2^" << b + 1 << ") ns " << timeInState[s][b] << '\n';
+            }
+        }
+    }
+};
+
+class PlayerTelemetry
+{
+public:
+    PlayerTelemetry()
+    {
+        std::lock_guard<std::mutex> lock(live().mutex);
+        live().serials.insert(serial);
+    }
+
+    ~PlayerTelemetry()
+    {
+        std::lock_guard<std::mutex> lock(live().mutex);
+        live().serials.erase(serial);
+    }
+
+    PlayerTelemetry(const PlayerTelemetry&) = delete;
+    PlayerTelemetry& operator=(const PlayerTelemetry&) = delete;
+
+    // What a player keeps per attached telemetry object (defined below)
+    class Recorder;
+
+    // A transition out of `from` after spending nsInFrom there
+    void recordTransition(PlayerState from, PlayerEvent e, PlayerState to, std::uint64_t nsInFrom)
+    {
+        addTransition(shard(), from, e, to, nsInFrom);
+    }
+
+    // An event the current state ignored ("already playing", ...)
+    void recordRejected(PlayerState state, PlayerEvent e)
+    {
+        addRejected(shard(), state, e);
+    }
+
+    TelemetrySnapshot snapshot() const
+    {
+        TelemetrySnapshot out;
+        std::lock_guard<std::mutex> lock(registry);
+        for (const auto& s : shards)
+        {
+            for (std::size_t f = 0; f < kStateCount; ++f)
+            {
+                for (std::size_t e = 0; e < kEventCount; ++e)
+                {
+                    for (std::size_t t = 0; t < kStateCount; ++t) out.transitions[f][e][t] += s->transitions[f][e][t].load(std::memory_order_relaxed);
+                    out.rejected[f][e] += s->rejected[f][e].load(std::memory_order_relaxed);
+                }
+                for (std::size_t b = 0; b < TelemetrySnapshot::kBuckets; ++b) out.timeInState[f][b] += s->timeInState[f][b].load(std::memory_order_relaxed);
+                out.nsInState[f] += s->nsInState[f].load(std::memory_order_relaxed);
+            }
+        }
+        return out;
+    }
+
+private:
+    using Counter = std::atomic<std::uint64_t>;
+
+    struct alignas(64) Shard
+    {
+        Counter transitions[kStateCount][kEventCount][kStateCount] = {};
+        Counter rejected[kStateCount][kEventCount] = {};
+        Counter timeInState[kStateCount][TelemetrySnapshot::kBuckets] = {};
+        Counter nsInState[kStateCount] = {};
+    };
+
+    template <class E>
+    static std::size_t index(E e) { return static_cast<std::size_t>(e); }
+
+    static std::size_t bucketOf(std::uint64_t ns)
+    {
+        const std::size_t b = ns ? static_cast<std::size_t>(std::bit_width(ns)) - 1 : 0;
+        return std::min(b, TelemetrySnapshot::kBuckets - 1);
+    }
+
+    // Only the owning thread writes a shard, so a load + store is enough
+    static void bump(Counter& c, std::uint64_t by = 1)
+    {
+        c.store(c.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    static void addTransition(Shard& s, PlayerState from, PlayerEvent e, PlayerState to, std::uint64_t nsInFrom)
+    {
+        bump(s.transitions[index(from)][index(e)][index(to)]);
+        bump(s.timeInState[index(from)][bucketOf(nsInFrom)]);
+        bump(s.nsInState[index(from)], nsInFrom);
+    }
+
+    static void addRejected(Shard& s, PlayerState state, PlayerEvent e)
+    {
+        bump(s.rejected[index(state)][index(e)]);
+    }
+
+    // The calling thread's shard: one per (thread, telemetry object). The
+    // thread keeps a small list keyed by serial number rather than `this`, so
+    // a new telemetry object at a recycled address never sees another one's
+    // shard. The last hit is checked first, which is the common case.
+    Shard& shard()
+    {
+        struct Entry
+        {
+            std::uint64_t owner;
+            Shard* shard;
+        };
+        thread_local std::vector<Entry> cache;
+        thread_local std::size_t last = 0;
+        if (last < cache.size() && cache[last].owner == serial) return *cache[last].shard;
+        for (std::size_t i = 0; i < cache.size(); ++i)
+        {
+            if (cache[i].owner == serial)
+            {
+                last = i;
+                return *cache[i].shard;
+            }
+        }
+        {
+            // Slow path: forget shards of telemetry objects that are gone
+            std::lock_guard<std::mutex> lock(live().mutex);
+            std::erase_if(cache, [](const Entry& e) { return !live().serials.contains(e.owner); });
+        }
+        auto s = std::make_unique<Shard>();
+        Shard* raw = s.get();
+        {
+            std::lock_guard<std::mutex> lock(registry);
+            shards.push_back(std::move(s));
+        }
+        last = cache.size();
+        cache.push_back({ serial, raw });
+        return *raw;
+    }
+
+    // Serials of telemetry objects that still exist
+    struct LiveSet
+    {
+        std::mutex mutex;
+        std::unordered_set<std::uint64_t> serials;
+    };
+
+    static LiveSet& live()
+    {
+        static LiveSet set;
+        return set;
+    }
+
+    static std::uint64_t nextSerial()
+    {
+        static std::atomic<std::uint64_t> counter{ 0 };
+        return ++counter;
+    }
+
+    const std::uint64_t serial = nextSerial();
+    mutable std::mutex registry;
+    std::vector<std::unique_ptr<Shard>> shards;
+};
+
+// A player's handle on its telemetry: the shard of the thread it last ran on,
+// looked up again only when the thread changes, so a recorded event costs a
+// thread-id compare rather than shard()'s list scan. Also tracks when the
+// player entered its current state, in TelemetryClock ticks.
+class PlayerTelemetry::Recorder
+{
+public:
+    Recorder() = default;
+
+    explicit Recorder(PlayerTelemetry& t)
+        : telemetry(&t)
+        , nsPerTick(TelemetryClock::nsPerTick())
+        , enteredAt(TelemetryClock::now())
+    {
+    }
+
+    explicit operator bool() const { return telemetry != nullptr; }
+
+    void transition(PlayerState from, PlayerEvent e, PlayerState to)
+    {
+        const std::uint64_t now = TelemetryClock::now();
+        const auto ns = static_cast<std::uint64_t>(double(now - enteredAt) * nsPerTick);
+        enteredAt = now;
+        addTransition(shard(), from, e, to, ns);
+    }
+
+    void rejected(PlayerState state, PlayerEvent e)
+    {
+        addRejected(shard(), state, e);
+    }
+
+private:
+    Shard& shard()
+    {
+        const std::thread::id self = std::this_thread::get_id();
+        if (self != thread)
+        {
+            cached = &telemetry->shard();
+            thread = self;
+        }
+        return *cached;
+    }
+
+    PlayerTelemetry* telemetry = nullptr;
+    Shard* cached = nullptr;
+    std::thread::id thread;
+    double nsPerTick = 1.0;
+    std::uint64_t enteredAt = 0;
+};
 
 // Forward declaration
 class AudioPlayer;
@@ -7,6 +758,8 @@ class AudioPlayer;
 // =======================
 // State interface
 // =======================
+// States carry no data, so each concrete state is a single shared instance
+// and a transition is just a pointer swap.
 class State
 {
 public:
@@ -17,36 +770,65 @@ public:
     virtual void stop(AudioPlayer& player) = 0;
 
     virtual const char* name() const = 0; // for printing
+
+    virtual PlayerState id() const = 0;
+
+    // Entry action: drives the attached audio pipeline, if any
+    virtual void enter(AudioPipeline& audio) const = 0;
 };
 
 // =======================
 // Concrete States
 // =======================
-class StoppedState : public State
+class StoppedState final : public State
 {
 public:
+    static State& instance()
+    {
+        static StoppedState state;
+        return state;
+    }
+
     void play(AudioPlayer& player) override;
     void pause(AudioPlayer& player) override;
     void stop(AudioPlayer& player) override;
     const char* name() const override { return "Stopped"; }
+    PlayerState id() const override { return PlayerState::Stopped; }
+    void enter(AudioPipeline& audio) const override { audio.stop(); }
 };
 
-class PlayingState : public State
+class PlayingState final : public State
 {
 public:
+    static State& instance()
+    {
+        static PlayingState state;
+        return state;
+    }
+
     void play(AudioPlayer& player) override;
     void pause(AudioPlayer& player) override;
     void stop(AudioPlayer& player) override;
     const char* name() const override { return "Playing"; }
+    PlayerState id() const override { return PlayerState::Playing; }
+    void enter(AudioPipeline& audio) const override { audio.play(); }
 };
 
-class PausedState : public State
+class PausedState final : public State
 {
 public:
+    static State& instance()
+    {
+        static PausedState state;
+        return state;
+    }
+
     void play(AudioPlayer& player) override;
     void pause(AudioPlayer& player) override;
     void stop(AudioPlayer& player) override;
     const char* name() const override { return "Paused"; }
+    PlayerState id() const override { return PlayerState::Paused; }
+    void enter(AudioPipeline& audio) const override { audio.pause(); }
 };
 
 // =======================
@@ -55,43 +837,84 @@ public:
 class AudioPlayer
 {
 public:
-    AudioPlayer()
-        : state(std::make_unique<StoppedState>()) // initial state
+    // With logging off, events neither print nor allocate.
+    explicit AudioPlayer(bool logging = true)
+        : state(&StoppedState::instance()) // initial state
+        , logging(logging)
+    {
+        if (logging) std::cout << "[Player] Initial state: " << state->name() << "\n\n";
+    }
+
+    // Optional: the player then produces real PCM through the pipeline
+    void attachAudio(AudioPipeline* pipeline)
+    {
+        audio = pipeline;
+    }
+
+    // Optional: records transitions, rejected events and time in each state
+    void attachTelemetry(PlayerTelemetry* t)
     {
-        std::cout << "[Player] Initial state: " << state->name() << "\n\n";
+        telemetry = t ? PlayerTelemetry::Recorder(*t) : PlayerTelemetry::Recorder();
     }
 
     // Called by states to change the current state
-    void setState(std::unique_ptr<State> newState)
+    void setState(State& newState)
+    {
+        state = &newState;
+        if (audio) state->enter(*audio);
+        ++transitionCount;
+        if (logging) std::cout << "[Player] State changed to: " << state->name() << "\n\n";
+    }
+
+    // Called by states to describe what they did
+    void log(const char* message) const
     {
-        state = std::move(newState);
-        std::cout << "[Player] State changed to: " << state->name() << "\n\n";
+        if (logging) std::cout << message;
     }
 
     // Public API
     void play()
     {
-        std::cout << "Command: play()\n";
+        log("Command: play()\n");
+        const State& before = *state;
         state->play(*this);
-        std::cout << "----------------------\n";
+        if (telemetry) record(before, PlayerEvent::Play);
+        log("----------------------\n");
     }
 
     void pause()
     {
-        std::cout << "Command: pause()\n";
+        log("Command: pause()\n");
+        const State& before = *state;
         state->pause(*this);
-        std::cout << "----------------------\n";
+        if (telemetry) record(before, PlayerEvent::Pause);
+        log("----------------------\n");
     }
 
     void stop()
     {
-        std::cout << "Command: stop()\n";
+        log("Command: stop()\n");
+        const State& before = *state;
         state->stop(*this);
-        std::cout << "----------------------\n";
+        if (telemetry) record(before, PlayerEvent::Stop);
+        log("----------------------\n");
     }
 
+    const State& current() const { return *state; }
+    std::uint64_t transitions() const { return transitionCount; }
+
 private:
-    std::unique_ptr<State> state;
+    void record(const State& before, PlayerEvent e)
+    {
+        if (state == &before) telemetry.rejected(before.id(), e);
+        else telemetry.transition(before.id(), e, state->id());
+    }
+
+    State* state;
+    AudioPipeline* audio = nullptr;
+    PlayerTelemetry::Recorder telemetry;
+    std::uint64_t transitionCount = 0;
+    bool logging;
 };
 
 // =======================
@@ -99,38 +922,38 @@ private:
 // =======================
 void StoppedState::play(AudioPlayer& player)
 {
-    std::cout << "  [StoppedState] start playing music\n";
-    player.setState(std::make_unique<PlayingState>());
+    player.log("  [StoppedState] start playing music\n");
+    player.setState(PlayingState::instance());
 }
 
-void StoppedState::pause(AudioPlayer&)
+void StoppedState::pause(AudioPlayer& player)
 {
-    std::cout << "  [StoppedState] pause() has no effect (already stopped)\n";
+    player.log("  [StoppedState] pause() has no effect (already stopped)\n");
 }
 
-void StoppedState::stop(AudioPlayer&)
+void StoppedState::stop(AudioPlayer& player)
 {
-    std::cout << "  [StoppedState] already stopped\n";
+    player.log("  [StoppedState] already stopped\n");
 }
 
 // =======================
 // PlayingState methods
 // =======================
-void PlayingState::play(AudioPlayer&)
+void PlayingState::play(AudioPlayer& player)
 {
-    std::cout << "  [PlayingState] already playing\n";
+    player.log("  [PlayingState] already playing\n");
 }
 
 void PlayingState::pause(AudioPlayer& player)
 {
-    std::cout << "  [PlayingState] pausing music\n";
-    player.setState(std::make_unique<PausedState>());
+    player.log("  [PlayingState] pausing music\n");
+    player.setState(PausedState::instance());
 }
 
 void PlayingState::stop(AudioPlayer& player)
 {
-    std::cout << "  [PlayingState] stopping music\n";
-    player.setState(std::make_unique<StoppedState>());
+    player.log("  [PlayingState] stopping music\n");
+    player.setState(StoppedState::instance());
 }
 
 // =======================
@@ -138,26 +961,504 @@ void PlayingState::stop(AudioPlayer& player)
 // =======================
 void PausedState::play(AudioPlayer& player)
 {
-    std::cout << "  [PausedState] resume playing\n";
-    player.setState(std::make_unique<PlayingState>());
+    player.log("  [PausedState] resume playing\n");
+    player.setState(PlayingState::instance());
 }
 
-void PausedState::pause(AudioPlayer&)
+void PausedState::pause(AudioPlayer& player)
 {
-    std::cout << "  [PausedState] already paused\n";
+    player.log("  [PausedState] already paused\n");
 }
 
 void PausedState::stop(AudioPlayer& player)
 {
-    std::cout << "  [PausedState] stopping from paused\n";
-    player.setState(std::make_unique<StoppedState>());
+    player.log("  [PausedState] stopping from paused\n");
+    player.setState(StoppedState::instance());
+}
+
+// =======================
+// Table-driven player
+// =======================
+// The same Stopped/Playing/Paused graph, declared in one place. The table is
+// built at compile time and static_asserts check that every state handles
+// every event exactly once. Dispatch is a single array lookup.
+// An event that leaves the state unchanged is rejected and logs its message only
+struct Transition
+{
+    PlayerState from = PlayerState::Count;
+    PlayerEvent event = PlayerEvent::Count;
+    PlayerState to = PlayerState::Count;
+    const char* message = nullptr;
+};
+
+inline constexpr Transition kTransitions[] = {
+    { PlayerState::Stopped, PlayerEvent::Play,  PlayerState::Playing, "  [StoppedState] start playing music\n" },
+    { PlayerState::Stopped, PlayerEvent::Pause, PlayerState::Stopped, "  [StoppedState] pause() has no effect (already stopped)\n" },
+    { PlayerState::Stopped, PlayerEvent::Stop,  PlayerState::Stopped, "  [StoppedState] already stopped\n" },
+    { PlayerState::Playing, PlayerEvent::Play,  PlayerState::Playing, "  [PlayingState] already playing\n" },
+    { PlayerState::Playing, PlayerEvent::Pause, PlayerState::Paused,  "  [PlayingState] pausing music\n" },
+    { PlayerState::Playing, PlayerEvent::Stop,  PlayerState::Stopped, "  [PlayingState] stopping music\n" },
+    { PlayerState::Paused,  PlayerEvent::Play,  PlayerState::Playing, "  [PausedState] resume playing\n" },
+    { PlayerState::Paused,  PlayerEvent::Pause, PlayerState::Paused,  "  [PausedState] already paused\n" },
+    { PlayerState::Paused,  PlayerEvent::Stop,  PlayerState::Stopped, "  [PausedState] stopping from paused\n" },
+};
+
+constexpr std::size_t cellOf(PlayerState s, PlayerEvent e)
+{
+    return static_cast<std::size_t>(s) * kEventCount + static_cast<std::size_t>(e);
+}
+
+constexpr bool everyEventHandledOnce()
+{
+    int seen[kStateCount * kEventCount] = {};
+    for (const Transition& t : kTransitions)
+    {
+        if (t.from >= PlayerState::Count || t.event >= PlayerEvent::Count || t.to >= PlayerState::Count) return false;
+        ++seen[cellOf(t.from, t.event)];
+    }
+    for (int n : seen)
+    {
+        if (n != 1) return false;
+    }
+    return true;
+}
+
+static_assert(everyEventHandledOnce(), "every (state, event) pair needs exactly one transition");
+
+using TransitionTable = std::array<Transition, kStateCount * kEventCount>;
+
+constexpr TransitionTable makeTransitionTable()
+{
+    TransitionTable table{};
+    for (const Transition& t : kTransitions) table[cellOf(t.from, t.event)] = t;
+    return table;
+}
+
+inline constexpr TransitionTable kTransitionTable = makeTransitionTable();
+
+static_assert(kTransitionTable[cellOf(PlayerState::Stopped, PlayerEvent::Play)].to == PlayerState::Playing);
+
+class TableAudioPlayer
+{
+public:
+    explicit TableAudioPlayer(bool logging = true)
+        : logging(logging)
+    {
+        if (logging) std::cout << "[Player] Initial state: " << stateName(state) << "\n\n";
+    }
+
+    // Optional: records transitions, rejected events and time in each state
+    void attachTelemetry(PlayerTelemetry* t)
+    {
+        telemetry = t ? PlayerTelemetry::Recorder(*t) : PlayerTelemetry::Recorder();
+    }
+
+    void play() { dispatch(PlayerEvent::Play); }
+    void pause() { dispatch(PlayerEvent::Pause); }
+    void stop() { dispatch(PlayerEvent::Stop); }
+
+    void dispatch(PlayerEvent e)
+    {
+        const Transition& t = kTransitionTable[cellOf(state, e)];
+        const bool changes = t.to != state;
+        if (telemetry) record(state, e, t.to);
+        state = t.to;
+        transitionCount += changes;
+        if (logging)
+        {
+            std::cout << commandLine(e) << t.message;
+            if (changes) std::cout << "[Player] State changed to: " << stateName(state) << "\n\n";
+            std::cout << "----------------------\n";
+        }
+    }
+
+    PlayerState current() const { return state; }
+    std::uint64_t transitions() const { return transitionCount; }
+
+private:
+    void record(PlayerState from, PlayerEvent e, PlayerState to)
+    {
+        if (from == to) telemetry.rejected(from, e);
+        else telemetry.transition(from, e, to);
+    }
+
+    PlayerState state = PlayerState::Stopped;
+    PlayerTelemetry::Recorder telemetry;
+    std::uint64_t transitionCount = 0;
+    bool logging;
+};
+
+// =======================
+// Player fleet
+// =======================
+// Millions of players driven by the same transition table. Each player is one
+// byte of state; events arrive in batches and are applied in parallel, each
+// thread owning a contiguous range of player ids. Events for one player are
+// always applied in batch order.
+using PlayerId = std::uint32_t;
+
+struct PlayerCommand
+{
+    PlayerId player;
+    PlayerEvent event;
+};
+
+// Next state for each (state, event) cell, as bytes for the hot loop
+inline constexpr auto kNextState = []
+{
+    std::array<std::uint8_t, kStateCount * kEventCount> next{};
+    for (std::size_t cell = 0; cell < next.size(); ++cell)
+    {
+        next[cell] = static_cast<std::uint8_t>(kTransitionTable[cell].to);
+    }
+    return next;
+}();
+
+class PlayerFleet
+{
+public:
+    // threads = 0 uses every hardware thread
+    explicit PlayerFleet(std::size_t players, unsigned threads = 0)
+        : states(players, static_cast<std::uint8_t>(PlayerState::Stopped))
+        , threadCount(threads ? threads : std::max(1u, std::thread::hardware_concurrency()))
+    {
+    }
+
+    std::size_t size() const { return states.size(); }
+    unsigned threads() const { return threadCount; }
+
+    PlayerState state(PlayerId id) const
+    {
+        return static_cast<PlayerState>(states.at(id));
+    }
+
+    std::size_t countIn(PlayerState s) const
+    {
+        return static_cast<std::size_t>(std::count(states.begin(), states.end(), static_cast<std::uint8_t>(s)));
+    }
+
+    // Applies the batch and returns how many events changed a player's state.
+    // Throws std::out_of_range, before applying anything, if an id is unknown.
+    std::uint64_t apply(std::span<const PlayerCommand> batch)
+    {
+        const unsigned t = threadCount;
+        if (t == 1 || batch.size() < kParallelThreshold)
+        {
+            for (const PlayerCommand& c : batch) checkId(c.player);
+            return applyRange(batch);
+        }
+
+        // Rows are input chunks, columns are shards of player ids
+        const std::size_t shardSize = (states.size() + t - 1) / t;
+        const std::size_t chunkSize = (batch.size() + t - 1) / t;
+        std::vector<std::size_t> offsets(std::size_t(t) * t, 0);
+        std::vector<std::uint64_t> changed(t, 0);
+        std::vector<char> badId(t, 0);
+        sorted.resize(batch.size());
+        std::barrier sync(t);
+
+        auto chunkOf = [&](unsigned c)
+        {
+            const std::size_t begin = std::min(batch.size(), c * chunkSize);
+            return batch.subspan(begin, std::min(chunkSize, batch.size() - begin));
+        };
+
+        auto worker = [&](unsigned w)
+        {
+            // 1. Count this chunk's events per shard
+            std::size_t* counts = &offsets[std::size_t(w) * t];
+            for (const PlayerCommand& c : chunkOf(w))
+            {
+                if (c.player >= states.size())
+                {
+                    badId[w] = 1;
+                    break;
+                }
+                ++counts[c.player / shardSize];
+            }
+            sync.arrive_and_wait();
+
+            // 2. One thread turns counts into scatter offsets: shard-major, so a
+            //    shard's events stay in batch order
+            if (w == 0 && std::find(badId.begin(), badId.end(), 1) == badId.end())
+            {
+                std::size_t running = 0;
+                for (unsigned shard = 0; shard < t; ++shard)
+                {
+                    for (unsigned c = 0; c < t; ++c)
+                    {
+                        std::size_t n = offsets[std::size_t(c) * t + shard];
+                        offsets[std::size_t(c) * t + shard] = running;
+                        running += n;
+                    }
+                }
+            }
+            sync.arrive_and_wait();
+            if (std::find(badId.begin(), badId.end(), 1) != badId.end()) return;
+
+            // 3. Scatter this chunk into the shard regions
+            std::size_t* cursor = &offsets[std::size_t(w) * t];
+            for (const PlayerCommand& c : chunkOf(w)) sorted[cursor[c.player / shardSize]++] = c;
+            sync.arrive_and_wait();
+
+            // 4. Apply this thread's shard; after the scatter the last chunk's
+            //    cursor for a shard is where the next shard begins
+            const std::size_t begin = w == 0 ? 0 : offsets[std::size_t(t - 1) * t + (w - 1)];
+            const std::size_t end = offsets[std::size_t(t - 1) * t + w];
+            changed[w] = applyRange(std::span<const PlayerCommand>(sorted).subspan(begin, end - begin));
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned w = 1; w < t; ++w) pool.emplace_back(worker, w);
+        worker(0);
+        for (auto& th : pool) th.join();
+
+        if (std::find(badId.begin(), badId.end(), 1) != badId.end())
+        {
+            throw std::out_of_range("PlayerFleet: unknown player id");
+        }
+        std::uint64_t total = 0;
+        for (std::uint64_t n : changed) total += n;
+        return total;
+    }
+
+private:
+    static constexpr std::size_t kParallelThreshold = 1 << 16;
+
+    void checkId(PlayerId id) const
+    {
+        if (id >= states.size())
+        {
+            throw std::out_of_range("PlayerFleet: unknown player id");
+        }
+    }
+
+    std::uint64_t applyRange(std::span<const PlayerCommand> commands)
+    {
+        std::uint8_t* s = states.data();
+        std::uint64_t changed = 0;
+        for (const PlayerCommand& c : commands)
+        {
+            const std::uint8_t from = s[c.player];
+            const std::uint8_t to = kNextState[from * kEventCount + static_cast<std::size_t>(c.event)];
+            s[c.player] = to;
+            changed += from != to;
+        }
+        return changed;
+    }
+
+    std::vector<std::uint8_t> states;
+    unsigned threadCount;
+    std::vector<PlayerCommand> sorted; // scratch for the parallel path
+};
+
+// =======================
+// Benchmark
+// =======================
+// Drives the same pseudo-random stream of play/pause/stop events through
+// each player with logging off.
+void deliver(AudioPlayer& player, PlayerEvent e)
+{
+    switch (e)
+    {
+    case PlayerEvent::Play: player.play(); break;
+    case PlayerEvent::Pause: player.pause(); break;
+    default: player.stop(); break;
+    }
+}
+
+void deliver(TableAudioPlayer& player, PlayerEvent e)
+{
+    player.dispatch(e);
+}
+
+template <class Player>
+void drive(const char* label, Player& player, const std::vector<PlayerEvent>& events)
+{
+    using Clock = std::chrono::steady_clock;
+    const std::size_t allocs = AllocCount.load();
+    auto t0 = Clock::now();
+    for (PlayerEvent e : events) deliver(player, e);
+    double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    std::cout << label << events.size() << " events in " << secs * 1e3 << " ms: " << events.size() / secs / 1e6
+        << " M events/s, " << player.transitions() << " transitions, "
+        << AllocCount.load() - allocs << " allocations\n";
+}
+
+// Random batches over a large fleet, parallel vs one thread
+void benchFleet()
+{
+    using Clock = std::chrono::steady_clock;
+    const std::size_t players = 16'000'000;
+    const std::size_t batchSize = 32'000'000;
+    const int batches = 4;
+
+    std::vector<PlayerCommand> batch(batchSize);
+    PlayerFleet parallel(players), serial(players, 1);
+    std::uint64_t x = 88172645463325252ull;
+    double parallelSecs = 0, serialSecs = 0;
+    std::uint64_t parallelChanged = 0, serialChanged = 0;
+    for (int b = 0; b < batches; ++b)
+    {
+        for (PlayerCommand& c : batch)
+        {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            c.player = static_cast<PlayerId>((x >> 32) % players);
+            c.event = static_cast<PlayerEvent>(x % 3);
+        }
+        auto t0 = Clock::now();
+        parallelChanged += parallel.apply(batch);
+        parallelSecs += std::chrono::duration<double>(Clock::now() - t0).count();
+        t0 = Clock::now();
+        serialChanged += serial.apply(batch);
+        serialSecs += std::chrono::duration<double>(Clock::now() - t0).count();
+    }
+
+    bool same = parallelChanged == serialChanged;
+    for (PlayerId id = 0; same && id < players; ++id) same = parallel.state(id) == serial.state(id);
+
+    const double events = double(batchSize) * batches;
+    std::cout << "\nFleet of " << players << " players, " << batches << " batches of " << batchSize << " events\n"
+        << "  " << parallel.threads() << " threads: " << events / parallelSecs / 1e6 << " M events/s\n"
+        << "  1 thread:  " << events / serialSecs / 1e6 << " M events/s\n"
+        << "  " << parallelChanged << " state changes; playing " << parallel.countIn(PlayerState::Playing)
+        << ", paused " << parallel.countIn(PlayerState::Paused) << ", stopped " << parallel.countIn(PlayerState::Stopped)
+        << (same ? "" : "  MISMATCH with single-threaded run") << "\n";
+}
+
+// Real-time playback into a null sink with pause/resume/stop, then a short WAV
+void benchAudio()
+{
+    using namespace std::chrono_literals;
+    NullSink sink;
+    PipelineStats s;
+    {
+        AudioPipeline pipeline(sink);
+        AudioPlayer player(false);
+        player.attachAudio(&pipeline);
+        player.play();
+        std::this_thread::sleep_for(400ms);
+        player.pause();
+        std::this_thread::sleep_for(100ms);
+        player.play();
+        std::this_thread::sleep_for(300ms);
+        player.stop();
+        std::this_thread::sleep_for(50ms);
+        s = pipeline.stats();
+    }
+
+    const double periodMs = std::chrono::duration<double, std::milli>(kPeriodTime).count();
+    std::cout << "\nPCM pipeline, " << kSampleRate << " Hz, " << kPeriodFrames << "-frame periods (" << periodMs << " ms)\n"
+        << "  " << s.periodsPlayed << " periods played, " << s.silentPeriods << " silent, "
+        << s.underruns << " underruns, " << s.dropped << " dropped on stop\n"
+        << "  latency avg " << s.avgLatencyMs << " ms, max " << s.maxLatencyMs << " ms\n"
+        << "  slowest command took effect after " << s.maxCommandDelayMs << " ms"
+        << (s.maxCommandDelayMs <= periodMs * 1.5 ? "" : "  (more than one period)") << "\n";
+
+    const auto path = std::filesystem::temp_directory_path() / "audio_player.wav";
+    {
+        WavSink wav(path.string());
+        AudioPipeline pipeline(wav);
+        AudioPlayer player(false);
+        player.attachAudio(&pipeline);
+        player.play();
+        std::this_thread::sleep_for(250ms);
+    }
+    std::cout << "  wrote " << std::filesystem::file_size(path) << " bytes to " << path.string() << "\n";
+    std::filesystem::remove(path);
+}
+
+// Per-event cost of telemetry, with several threads recording into one object
+void benchTelemetry(const std::vector<PlayerEvent>& events)
+{
+    using Clock = std::chrono::steady_clock;
+    const unsigned threads = 4;
+    const std::size_t perThread = 10'000'000;
+    PlayerTelemetry telemetry;
+
+    auto run = [&](bool instrumented)
+    {
+        std::vector<std::thread> pool;
+        std::vector<std::uint64_t> transitions(threads);
+        auto t0 = Clock::now();
+        for (unsigned w = 0; w < threads; ++w)
+        {
+            pool.emplace_back([&, w]
+            {
+                TableAudioPlayer player(false);
+                if (instrumented) player.attachTelemetry(&telemetry);
+                for (std::size_t i = 0; i < perThread; ++i) player.dispatch(events[w * perThread + i]);
+                transitions[w] = player.transitions();
+            });
+        }
+        for (auto& th : pool) th.join();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / (double(threads) * perThread);
+        std::uint64_t total = 0;
+        for (std::uint64_t n : transitions) total += n;
+        return std::pair{ ns, total };
+    };
+
+    auto [plainNs, plainTransitions] = run(false);
+    auto [tracedNs, tracedTransitions] = run(true);
+    const TelemetrySnapshot snap = telemetry.snapshot();
+    std::uint64_t recorded = 0, rejected = 0;
+    for (auto& perEvent : snap.transitions)
+        for (auto& perTo : perEvent)
+            for (std::uint64_t n : perTo) recorded += n;
+    for (auto& perState : snap.rejected)
+        for (std::uint64_t n : perState) rejected += n;
+
+    std::cout << "\nTelemetry, " << threads << " threads x " << perThread << " events\n"
+        << "  without " << plainNs << " ns/event, with " << tracedNs << " ns/event\n"
+        << "  " << recorded << " transitions + " << rejected << " rejected recorded"
+        << (recorded == tracedTransitions && recorded + rejected == threads * perThread && plainTransitions == tracedTransitions
+            ? "" : "  MISMATCH") << "\n";
+    snap.writeText(std::cout);
+}
+
+void runBenchmark()
+{
+    std::vector<PlayerEvent> events(100'000'000);
+    std::uint32_t x = 2463534242u;
+    for (PlayerEvent& e : events)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        e = static_cast<PlayerEvent>(x % 3);
+    }
+
+    AudioPlayer virtualPlayer(false);
+    drive("virtual states:  ", virtualPlayer, events);
+
+    TableAudioPlayer tablePlayer(false);
+    drive("constexpr table: ", tablePlayer, events);
+
+    if (virtualPlayer.transitions() != tablePlayer.transitions()
+        || std::strcmp(virtualPlayer.current().name(), stateName(tablePlayer.current())) != 0)
+    {
+        std::cout << "MISMATCH between virtual and table-driven players\n";
+    }
+
+    benchTelemetry(events);
+    benchFleet();
+    benchAudio();
 }
 
 // =======================
 // Demo
 // =======================
-int main()
+int main(int argc, char** argv)
 {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+    {
+        runBenchmark();
+        return 0;
+    }
+
     AudioPlayer player;
 
     player.play();   // Stopped -> Playing
@@ -166,5 +1467,14 @@ int main()
     player.stop();   // Playing -> Stopped
     player.stop();   // already stopped
 
+    std::cout << "\n=== Table-driven player, same script ===\n";
+    TableAudioPlayer table;
+
+    table.play();
+    table.pause();
+    table.play();
+    table.stop();
+    table.stop();
+
     return 0;
 }
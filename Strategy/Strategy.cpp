@@ -1,5 +1,179 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <initializer_list>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <variant>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define STRATEGY_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// 0. SIMD support for batch execution
+//    Kernels for each instruction set are compiled into the binary and the best
+//    one the CPU supports is picked at runtime. Batch results wrap on overflow
+//    (two's complement), which matches the scalar execute() for every input
+//    where that one is defined.
+enum class SimdLevel
+{
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+inline const char* simdName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::AVX2: return "AVX2";
+    case SimdLevel::SSE41: return "SSE4.1";
+    default: return "scalar";
+    }
+}
+
+inline SimdLevel detectSimd()
+{
+#if defined(STRATEGY_X86)
+#ifdef _MSC_VER
+    int r[4];
+    __cpuid(r, 0);
+    const int maxLeaf = r[0];
+    __cpuid(r, 1);
+    const bool sse41 = (r[2] & (1 << 19)) != 0;
+    const bool osxsave = (r[2] & (1 << 27)) != 0;
+    const bool avx = (r[2] & (1 << 28)) != 0;
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) // OS saves YMM state
+    {
+        __cpuidex(r, 7, 0);
+        avx2 = (r[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool sse41 = __builtin_cpu_supports("sse4.1");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2) return SimdLevel::AVX2;
+    if (sse41) return SimdLevel::SSE41;
+#endif
+    return SimdLevel::Scalar;
+}
+
+inline SimdLevel bestSimd()
+{
+    static const SimdLevel level = detectSimd();
+    return level;
+}
+
+// Element-wise operations, one implementation per instruction set
+struct AddOp
+{
+    static int scalar(int a, int b) { return static_cast<int>(static_cast<unsigned>(a) + static_cast<unsigned>(b)); }
+#if defined(STRATEGY_X86)
+    TARGET_SSE41 static __m128i sse41(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+    TARGET_AVX2 static __m256i avx2(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+#endif
+};
+
+struct SubtractOp
+{
+    static int scalar(int a, int b) { return static_cast<int>(static_cast<unsigned>(a) - static_cast<unsigned>(b)); }
+#if defined(STRATEGY_X86)
+    TARGET_SSE41 static __m128i sse41(__m128i a, __m128i b) { return _mm_sub_epi32(a, b); }
+    TARGET_AVX2 static __m256i avx2(__m256i a, __m256i b) { return _mm256_sub_epi32(a, b); }
+#endif
+};
+
+struct MultiplyOp
+{
+    static int scalar(int a, int b) { return static_cast<int>(static_cast<unsigned>(a) * static_cast<unsigned>(b)); }
+#if defined(STRATEGY_X86)
+    TARGET_SSE41 static __m128i sse41(__m128i a, __m128i b) { return _mm_mullo_epi32(a, b); }
+    TARGET_AVX2 static __m256i avx2(__m256i a, __m256i b) { return _mm256_mullo_epi32(a, b); }
+#endif
+};
+
+using BatchKernel = void (*)(const int* a, const int* b, int* out, std::size_t n);
+
+template <class Op>
+void scalarKernel(const int* a, const int* b, int* out, std::size_t n)
+{
+    for (std::size_t i = 0; i < n; ++i) out[i] = Op::scalar(a[i], b[i]);
+}
+
+#if defined(STRATEGY_X86)
+template <class Op>
+TARGET_SSE41 void sse41Kernel(const int* a, const int* b, int* out, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), Op::sse41(va, vb));
+    }
+    scalarKernel<Op>(a + i, b + i, out + i, n - i);
+}
+
+template <class Op>
+TARGET_AVX2 void avx2Kernel(const int* a, const int* b, int* out, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), Op::avx2(va, vb));
+    }
+    scalarKernel<Op>(a + i, b + i, out + i, n - i);
+}
+#endif
+
+// Kernel for a given level; falls back to the next lower one that exists
+template <class Op>
+BatchKernel batchKernel(SimdLevel level)
+{
+#if defined(STRATEGY_X86)
+    if (level == SimdLevel::AVX2) return &avx2Kernel<Op>;
+    if (level == SimdLevel::SSE41) return &sse41Kernel<Op>;
+#endif
+    (void)level;
+    return &scalarKernel<Op>;
+}
+
+template <class Op>
+void runBatch(std::span<const int> a, std::span<const int> b, std::span<int> out)
+{
+    static const BatchKernel kernel = batchKernel<Op>(bestSimd());
+    kernel(a.data(), b.data(), out.data(), out.size());
+}
 
 // 1. Strategy interface: different algorithms share this interface
 class OperationStrategy
@@ -7,35 +181,336 @@ class OperationStrategy
 public:
     virtual ~OperationStrategy() = default;
     virtual int execute(int a, int b) const = 0;
+
+    // Batch form: out[i] = execute(a[i], b[i]). The default loops over execute();
+    // concrete strategies override it with vectorized kernels.
+    void execute(std::span<const int> a, std::span<const int> b, std::span<int> out) const
+    {
+        if (a.size() != out.size() || b.size() != out.size())
+        {
+            throw std::invalid_argument("execute: operand and result sizes differ");
+        }
+        executeBatch(a, b, out);
+    }
+
+protected:
+    virtual void executeBatch(std::span<const int> a, std::span<const int> b, std::span<int> out) const
+    {
+        for (std::size_t i = 0; i < out.size(); ++i) out[i] = execute(a[i], b[i]);
+    }
 };
 
 // 2. Concrete strategies: different ways to do the operation
 
-class AddStrategy : public OperationStrategy
+class AddStrategy final : public OperationStrategy
 {
 public:
+    using OperationStrategy::execute;
+
     int execute(int a, int b) const override
     {
         return a + b;
     }
+
+protected:
+    void executeBatch(std::span<const int> a, std::span<const int> b, std::span<int> out) const override
+    {
+        runBatch<AddOp>(a, b, out);
+    }
 };
 
-class SubtractStrategy : public OperationStrategy
+class SubtractStrategy final : public OperationStrategy
 {
 public:
+    using OperationStrategy::execute;
+
     int execute(int a, int b) const override
     {
         return a - b;
     }
+
+protected:
+    void executeBatch(std::span<const int> a, std::span<const int> b, std::span<int> out) const override
+    {
+        runBatch<SubtractOp>(a, b, out);
+    }
 };
 
-class MultiplyStrategy : public OperationStrategy
+class MultiplyStrategy final : public OperationStrategy
 {
 public:
+    using OperationStrategy::execute;
+
     int execute(int a, int b) const override
     {
         return a * b;
     }
+
+protected:
+    void executeBatch(std::span<const int> a, std::span<const int> b, std::span<int> out) const override
+    {
+        runBatch<MultiplyOp>(a, b, out);
+    }
+};
+
+// 2b. Autotuning: several implementations of the same strategy, each fastest at
+//     some sizes. Batch sizes are grouped into power-of-two buckets; the first
+//     call in a bucket times every implementation, reading the caller's operands
+//     but writing into private scratch, and later calls in that bucket go
+//     straight to the winner.
+template <class Op>
+void unrolledKernel(const int* a, const int* b, int* out, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        out[i] = Op::scalar(a[i], b[i]);
+        out[i + 1] = Op::scalar(a[i + 1], b[i + 1]);
+        out[i + 2] = Op::scalar(a[i + 2], b[i + 2]);
+        out[i + 3] = Op::scalar(a[i + 3], b[i + 3]);
+    }
+    scalarKernel<Op>(a + i, b + i, out + i, n - i);
+}
+
+template <class Op>
+void simdKernel(const int* a, const int* b, int* out, std::size_t n)
+{
+    runBatch<Op>({ a, n }, { b, n }, { out, n });
+}
+
+// Splits the range across all hardware threads, each running the SIMD kernel
+template <class Op>
+void threadedKernel(const int* a, const int* b, int* out, std::size_t n)
+{
+    const std::size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t chunk = (n + workers - 1) / workers;
+    std::vector<std::thread> threads;
+    for (std::size_t begin = chunk; begin < n; begin += chunk)
+    {
+        threads.emplace_back(simdKernel<Op>, a + begin, b + begin, out + begin, std::min(chunk, n - begin));
+    }
+    simdKernel<Op>(a, b, out, std::min(chunk, n));
+    for (auto& t : threads) t.join();
+}
+
+class Autotuner
+{
+public:
+    struct Implementation
+    {
+        std::string name;
+        BatchKernel kernel;
+    };
+
+    struct PlanEntry
+    {
+        std::string strategy;
+        unsigned bucket;            // sizes in [2^bucket, 2^(bucket + 1))
+        std::string implementation;
+        double nsPerElement;        // measured while tuning; 0 if loaded from a profile
+    };
+
+    static constexpr unsigned kBuckets = 64;
+
+    static unsigned bucketOf(std::size_t n)
+    {
+        unsigned bucket = 0;
+        while (n > 1)
+        {
+            n >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    // scalar, unrolled, SIMD and threaded implementations of the built-in strategies
+    static std::shared_ptr<Autotuner> standard()
+    {
+        auto tuner = std::make_shared<Autotuner>();
+        tuner->registerStrategy<AddStrategy>("add", implementationsOf<AddOp>());
+        tuner->registerStrategy<SubtractStrategy>("subtract", implementationsOf<SubtractOp>());
+        tuner->registerStrategy<MultiplyStrategy>("multiply", implementationsOf<MultiplyOp>());
+        return tuner;
+    }
+
+    // `name` identifies the strategy in profile files; implementations must all
+    // compute exactly what Strategy's batch execute() does.
+    template <class Strategy>
+    void registerStrategy(std::string name, std::vector<Implementation> implementations)
+    {
+        if (implementations.empty())
+        {
+            throw std::invalid_argument("Autotuner: no implementations for " + name);
+        }
+        auto f = std::make_shared<Family>();
+        f->name = std::move(name);
+        f->implementations = std::move(implementations);
+        std::unique_lock<std::shared_mutex> lock(registry);
+        families[std::type_index(typeid(Strategy))] = std::move(f);
+    }
+
+    // Runs the fastest registered implementation of the strategy for this size,
+    // tuning the size bucket first if needed. Returns false, without touching
+    // out, when the strategy has no registered implementations.
+    bool tryExecute(const OperationStrategy& s, std::span<const int> a, std::span<const int> b, std::span<int> out)
+    {
+        if (a.size() != out.size() || b.size() != out.size())
+        {
+            throw std::invalid_argument("execute: operand and result sizes differ");
+        }
+        const unsigned bucket = bucketOf(out.size());
+        BatchKernel kernel = nullptr;
+        std::shared_ptr<Family> untuned;
+        {
+            // Shared: concurrent callers only contend with registerStrategy()
+            std::shared_lock<std::shared_mutex> lock(registry);
+            auto it = families.find(std::type_index(typeid(s)));
+            if (it == families.end()) return false;
+            const int choice = it->second->choice[bucket].load(std::memory_order_acquire);
+            if (choice >= 0) kernel = it->second->implementations[choice].kernel;
+            else untuned = it->second;
+        }
+        // Tuning runs every kernel for a while, so it happens with the registry
+        // unlocked and registerStrategy() never waits on it. The snapshot keeps
+        // the family alive if it is replaced meanwhile.
+        if (!kernel) kernel = untuned->implementations[tune(*untuned, bucket, a, b)].kernel;
+        kernel(a.data(), b.data(), out.data(), out.size());
+        return true;
+    }
+
+    // Every tuned or loaded (strategy, bucket) decision
+    std::vector<PlanEntry> plan() const
+    {
+        std::shared_lock<std::shared_mutex> lock(registry);
+        std::vector<PlanEntry> entries;
+        for (const auto& [type, f] : families)
+        {
+            std::lock_guard<std::mutex> tuning(f->tuning);
+            for (unsigned bucket = 0; bucket < kBuckets; ++bucket)
+            {
+                const int choice = f->choice[bucket].load(std::memory_order_relaxed);
+                if (choice < 0) continue;
+                entries.push_back({ f->name, bucket, f->implementations[choice].name, f->nsPerElement[bucket] });
+            }
+        }
+        std::sort(entries.begin(), entries.end(), [](const PlanEntry& x, const PlanEntry& y)
+        {
+            return std::tie(x.strategy, x.bucket) < std::tie(y.strategy, y.bucket);
+        });
+        return entries;
+    }
+
+    void printPlan(std::ostream& os) const
+    {
+        for (const PlanEntry& e : plan())
+        {
+            os << "  " << std::left << std::setw(10) << e.strategy << std::right << " n >= 2^" << std::setw(2) << e.bucket
+                << "  " << std::left << std::setw(9) << e.implementation << std::right;
+            if (e.nsPerElement > 0) os << std::fixed << std::setprecision(3) << e.nsPerElement << " ns/element";
+            os << "\n";
+        }
+    }
+
+    // Profile format: one "<strategy> <bucket> <implementation>" per line
+    void saveProfile(const std::string& path) const
+    {
+        std::ofstream file(path);
+        if (!file)
+        {
+            throw std::runtime_error("Autotuner: cannot write " + path);
+        }
+        for (const PlanEntry& e : plan()) file << e.strategy << ' ' << e.bucket << ' ' << e.implementation << '\n';
+    }
+
+    // Adopts the decisions in a saved profile. Entries naming strategies or
+    // implementations that aren't registered are ignored, so a profile from
+    // another build still loads. Returns false if the file can't be opened.
+    bool loadProfile(const std::string& path)
+    {
+        std::ifstream file(path);
+        if (!file) return false;
+        std::shared_lock<std::shared_mutex> lock(registry);
+        std::string strategy, implementation;
+        unsigned bucket;
+        while (file >> strategy >> bucket >> implementation)
+        {
+            if (bucket >= kBuckets) continue;
+            for (auto& [type, f] : families)
+            {
+                if (f->name != strategy) continue;
+                std::lock_guard<std::mutex> tuning(f->tuning);
+                for (std::size_t k = 0; k < f->implementations.size(); ++k)
+                {
+                    if (f->implementations[k].name != implementation) continue;
+                    f->nsPerElement[bucket] = 0;
+                    f->choice[bucket].store(static_cast<int>(k), std::memory_order_release);
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Family
+    {
+        std::string name;
+        std::vector<Implementation> implementations;
+        std::array<std::atomic<int>, kBuckets> choice; // index into implementations, -1 = untuned
+        std::array<double, kBuckets> nsPerElement{};   // guarded by tuning
+        mutable std::mutex tuning;                     // one tuning run per family at a time
+
+        Family()
+        {
+            for (auto& c : choice) c.store(-1, std::memory_order_relaxed);
+        }
+    };
+
+    template <class Op>
+    static std::vector<Implementation> implementationsOf()
+    {
+        return {
+            { "scalar", &scalarKernel<Op> },
+            { "unrolled", &unrolledKernel<Op> },
+            { "simd", &simdKernel<Op> },
+            { "threaded", &threadedKernel<Op> },
+        };
+    }
+
+    // Times each implementation on the caller's operands, writing into private
+    // scratch so the caller's buffers (which may alias) are never touched.
+    // Returns the winner; another thread may have tuned the bucket meanwhile.
+    static int tune(Family& f, unsigned bucket, std::span<const int> a, std::span<const int> b)
+    {
+        using Clock = std::chrono::steady_clock;
+        std::lock_guard<std::mutex> lock(f.tuning);
+        const int known = f.choice[bucket].load(std::memory_order_relaxed);
+        if (known >= 0) return known;
+
+        std::vector<int> scratch(a.size());
+        const std::size_t n = std::max<std::size_t>(a.size(), 1);
+        const int reps = static_cast<int>(std::clamp<std::size_t>((std::size_t(1) << 16) / n, 1, 1000));
+        double best = 0;
+        int winner = 0;
+        for (std::size_t k = 0; k < f.implementations.size(); ++k)
+        {
+            BatchKernel kernel = f.implementations[k].kernel;
+            kernel(a.data(), b.data(), scratch.data(), scratch.size()); // warm up
+            auto t0 = Clock::now();
+            for (int r = 0; r < reps; ++r) kernel(a.data(), b.data(), scratch.data(), scratch.size());
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / reps / n;
+            if (k == 0 || ns < best)
+            {
+                best = ns;
+                winner = static_cast<int>(k);
+            }
+        }
+        f.nsPerElement[bucket] = best;
+        f.choice[bucket].store(winner, std::memory_order_release);
+        return winner;
+    }
+
+    mutable std::shared_mutex registry; // families: shared for lookups, exclusive to register
+    std::unordered_map<std::type_index, std::shared_ptr<Family>> families;
 };
 
 // 3. Context: uses a Strategy, but does not care which one specifically
@@ -47,6 +522,13 @@ public:
         strategy = std::move(s);
     }
 
+    // Optional: batch calls then run whichever registered implementation of
+    // the strategy the tuner found fastest for that size.
+    void setAutotuner(std::shared_ptr<Autotuner> t)
+    {
+        autotuner = std::move(t);
+    }
+
     int doOperation(int a, int b) const
     {
         if (!strategy)
@@ -57,12 +539,702 @@ public:
         return strategy->execute(a, b);
     }
 
+    void doOperation(std::span<const int> a, std::span<const int> b, std::span<int> out) const
+    {
+        if (!strategy)
+        {
+            std::cout << "No strategy set!\n";
+            return;
+        }
+        if (autotuner && autotuner->tryExecute(*strategy, a, b, out)) return;
+        strategy->execute(a, b, out);
+    }
+
 private:
     std::unique_ptr<OperationStrategy> strategy;
+    std::shared_ptr<Autotuner> autotuner;
+};
+
+// 3b. Compile-time context: the strategy is a template parameter, held by value.
+//     Strategies are final, so every call binds statically and can be inlined.
+template <class Strategy>
+class StaticCalculatorContext
+{
+public:
+    int doOperation(int a, int b) const
+    {
+        return strategy.execute(a, b);
+    }
+
+    void doOperation(std::span<const int> a, std::span<const int> b, std::span<int> out) const
+    {
+        strategy.execute(a, b, out);
+    }
+
+private:
+    Strategy strategy;
+};
+
+// 3c. Runtime switching without heap or virtual calls: the strategy lives in a
+//     variant and std::visit dispatches on its index.
+using AnyStrategy = std::variant<std::monostate, AddStrategy, SubtractStrategy, MultiplyStrategy>;
+
+class VariantCalculatorContext
+{
+public:
+    void setStrategy(AnyStrategy s)
+    {
+        strategy = s;
+    }
+
+    int doOperation(int a, int b) const
+    {
+        return std::visit([&](const auto& s) -> int
+        {
+            if constexpr (std::is_same_v<std::decay_t<decltype(s)>, std::monostate>)
+            {
+                std::cout << "No strategy set!\n";
+                return 0;
+            }
+            else
+            {
+                return s.execute(a, b);
+            }
+        }, strategy);
+    }
+
+    void doOperation(std::span<const int> a, std::span<const int> b, std::span<int> out) const
+    {
+        std::visit([&](const auto& s)
+        {
+            if constexpr (std::is_same_v<std::decay_t<decltype(s)>, std::monostate>)
+            {
+                std::cout << "No strategy set!\n";
+            }
+            else
+            {
+                s.execute(a, b, out);
+            }
+        }, strategy);
+    }
+
+private:
+    AnyStrategy strategy;
 };
 
-int main()
+// 3d. Concurrent context: strategies can be swapped while other threads compute.
+//     Readers never lock. Each one announces the epoch it entered in a private
+//     slot, then loads the current strategy. A writer publishes the new strategy,
+//     advances the epoch, and frees a retired strategy only once every reader
+//     slot is idle or has entered a later epoch (epoch-based reclamation).
+class ConcurrentCalculatorContext
 {
+    struct alignas(64) Slot
+    {
+        std::atomic<std::uint64_t> epoch{ 0 }; // 0 = not inside a call
+        std::atomic<bool> claimed{ false };
+    };
+
+public:
+    static constexpr std::size_t kMaxReaders = 64;
+
+    // One per reader thread; not shareable between threads. Moving a Reader
+    // hands its slot over; the moved-from one throws std::logic_error if used.
+    class Reader
+    {
+    public:
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        Reader(Reader&& other) noexcept
+            : context(other.context), slot(other.slot)
+        {
+            other.slot = nullptr;
+        }
+
+        ~Reader()
+        {
+            if (slot) slot->claimed.store(false, std::memory_order_release);
+        }
+
+        int doOperation(int a, int b) const
+        {
+            Guard guard(*context, ownSlot());
+            if (!guard.strategy)
+            {
+                std::cout << "No strategy set!\n";
+                return 0;
+            }
+            return guard.strategy->execute(a, b);
+        }
+
+        void doOperation(std::span<const int> a, std::span<const int> b, std::span<int> out) const
+        {
+            Guard guard(*context, ownSlot());
+            if (!guard.strategy)
+            {
+                std::cout << "No strategy set!\n";
+                return;
+            }
+            guard.strategy->execute(a, b, out);
+        }
+
+    private:
+        friend class ConcurrentCalculatorContext;
+
+        Reader(const ConcurrentCalculatorContext& c, Slot& s)
+            : context(&c), slot(&s)
+        {
+        }
+
+        Slot& ownSlot() const
+        {
+            if (!slot) throw std::logic_error("ConcurrentCalculatorContext::Reader used after being moved from");
+            return *slot;
+        }
+
+        // Pins the current epoch for the duration of one call.
+        // Both steps are seq_cst so a writer that advanced the epoch either sees
+        // this slot or this reader sees the writer's new strategy.
+        struct Guard
+        {
+            Guard(const ConcurrentCalculatorContext& c, Slot& s)
+                : slot(s)
+            {
+                slot.epoch.store(c.epoch.load());
+                strategy = c.current.load();
+            }
+
+            ~Guard()
+            {
+                slot.epoch.store(0, std::memory_order_release);
+            }
+
+            Slot& slot;
+            const OperationStrategy* strategy;
+        };
+
+        const ConcurrentCalculatorContext* context;
+        Slot* slot;
+    };
+
+    ConcurrentCalculatorContext() = default;
+    ConcurrentCalculatorContext(const ConcurrentCalculatorContext&) = delete;
+    ConcurrentCalculatorContext& operator=(const ConcurrentCalculatorContext&) = delete;
+
+    // All readers must be gone before the context is destroyed.
+    ~ConcurrentCalculatorContext()
+    {
+        delete current.load();
+    }
+
+    // Throws std::runtime_error when all kMaxReaders slots are taken.
+    Reader reader() const
+    {
+        for (Slot& s : slots)
+        {
+            bool expected = false;
+            if (!s.claimed.load(std::memory_order_relaxed)
+                && s.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                return Reader(*this, s);
+            }
+        }
+        throw std::runtime_error("ConcurrentCalculatorContext: too many readers");
+    }
+
+    // Safe to call while readers are running. Writers serialize on a mutex.
+    void setStrategy(std::unique_ptr<OperationStrategy> s)
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        std::unique_ptr<OperationStrategy> old(const_cast<OperationStrategy*>(current.exchange(s.release())));
+        const std::uint64_t retiredAt = epoch.fetch_add(1);
+        if (old) retired.push_back({ std::move(old), retiredAt });
+        reclaim();
+    }
+
+    // Frees whatever retired strategies no reader can still be using.
+    // setStrategy() does this too; call it when swaps stop.
+    void collect()
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        reclaim();
+    }
+
+    // Strategies retired but still possibly in use by a reader.
+    std::size_t pendingReclaim() const
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        return retired.size();
+    }
+
+private:
+    struct Retired
+    {
+        std::unique_ptr<OperationStrategy> strategy;
+        std::uint64_t epoch;
+    };
+
+    void reclaim()
+    {
+        std::uint64_t oldestActive = UINT64_MAX;
+        for (const Slot& s : slots)
+        {
+            std::uint64_t e = s.epoch.load();
+            if (e != 0) oldestActive = std::min(oldestActive, e);
+        }
+        // A reader that entered at epoch e may hold anything retired at e or later
+        std::erase_if(retired, [&](const Retired& r) { return r.epoch < oldestActive; });
+    }
+
+    std::atomic<const OperationStrategy*> current{ nullptr };
+    std::atomic<std::uint64_t> epoch{ 1 };
+    mutable Slot slots[kMaxReaders];
+    mutable std::mutex writer;
+    std::vector<Retired> retired;
+};
+
+// 3e. Pipelines: strategies composed into an expression such as (a + b) * c and
+//     evaluated in one pass. Operands are processed in blocks small enough that
+//     intermediate results stay in L1 instead of becoming full-size arrays.
+class Pipeline
+{
+    struct Node
+    {
+        std::shared_ptr<const OperationStrategy> strategy; // null for an input
+        std::size_t input = 0;
+        std::shared_ptr<const Node> lhs, rhs;
+    };
+
+public:
+    static constexpr std::size_t kBlock = 1024;
+
+    // The index-th operand array passed to run()
+    static Pipeline input(std::size_t index)
+    {
+        auto node = std::make_shared<Node>();
+        node->input = index;
+        return Pipeline(std::move(node));
+    }
+
+    // strategy(lhs, rhs), element-wise
+    static Pipeline apply(std::shared_ptr<const OperationStrategy> strategy, const Pipeline& lhs, const Pipeline& rhs)
+    {
+        if (!strategy)
+        {
+            throw std::invalid_argument("Pipeline: null strategy");
+        }
+        auto node = std::make_shared<Node>();
+        node->strategy = std::move(strategy);
+        node->lhs = lhs.root;
+        node->rhs = rhs.root;
+        return Pipeline(std::move(node));
+    }
+
+    // out[i] = expression over inputs[k][i]. Every input must be out.size() long.
+    void run(std::span<const std::span<const int>> inputs, std::span<int> out) const
+    {
+        std::vector<Step> steps;
+        std::size_t inputsUsed = 0;
+        const Operand result = compile(*root, steps, inputsUsed);
+        if (inputsUsed > inputs.size())
+        {
+            throw std::invalid_argument("Pipeline: missing input arrays");
+        }
+        for (const auto& in : inputs)
+        {
+            if (in.size() != out.size())
+            {
+                throw std::invalid_argument("Pipeline: operand and result sizes differ");
+            }
+        }
+        if (result.isInput)
+        {
+            std::copy(inputs[result.index].begin(), inputs[result.index].end(), out.begin());
+            return;
+        }
+
+        // One block-sized register per step except the last, which writes to out
+        std::vector<int> scratch((steps.size() - 1) * kBlock);
+        for (std::size_t begin = 0; begin < out.size(); begin += kBlock)
+        {
+            const std::size_t len = std::min(kBlock, out.size() - begin);
+            auto view = [&](Operand o) -> std::span<const int>
+            {
+                if (o.isInput) return inputs[o.index].subspan(begin, len);
+                return { scratch.data() + o.index * kBlock, len };
+            };
+            for (std::size_t k = 0; k < steps.size(); ++k)
+            {
+                std::span<int> dst = k + 1 == steps.size()
+                    ? out.subspan(begin, len)
+                    : std::span<int>(scratch.data() + k * kBlock, len);
+                steps[k].strategy->execute(view(steps[k].lhs), view(steps[k].rhs), dst);
+            }
+        }
+    }
+
+    void run(std::initializer_list<std::span<const int>> inputs, std::span<int> out) const
+    {
+        run(std::span<const std::span<const int>>(inputs.begin(), inputs.size()), out);
+    }
+
+private:
+    // Where a step reads from: an input array or an earlier step's register
+    struct Operand
+    {
+        bool isInput;
+        std::size_t index;
+    };
+
+    struct Step
+    {
+        const OperationStrategy* strategy;
+        Operand lhs, rhs;
+    };
+
+    explicit Pipeline(std::shared_ptr<const Node> n)
+        : root(std::move(n))
+    {
+    }
+
+    // Post-order flattening: operands are always computed before their user
+    static Operand compile(const Node& n, std::vector<Step>& steps, std::size_t& inputsUsed)
+    {
+        if (!n.strategy)
+        {
+            inputsUsed = std::max(inputsUsed, n.input + 1);
+            return { true, n.input };
+        }
+        Operand lhs = compile(*n.lhs, steps, inputsUsed);
+        Operand rhs = compile(*n.rhs, steps, inputsUsed);
+        steps.push_back({ n.strategy.get(), lhs, rhs });
+        return { false, steps.size() - 1 };
+    }
+
+    std::shared_ptr<const Node> root;
+};
+
+// 4. Benchmark: per-element virtual calls vs batch kernels
+template <class Op, class Strategy>
+void benchOperation(const char* label, const std::vector<int>& a, const std::vector<int>& b)
+{
+    using Clock = std::chrono::steady_clock;
+    const std::size_t n = a.size();
+    const int passes = static_cast<int>((std::size_t(1) << 28) / n);
+    std::vector<int> expected(n), out(n);
+
+    CalculatorContext context;
+    context.setStrategy(std::make_unique<Strategy>());
+
+    auto report = [&](const char* how, Clock::duration t)
+    {
+        double secs = std::chrono::duration<double>(t).count();
+        std::cout << "  " << std::left << std::setw(22) << how << std::right << std::fixed << std::setprecision(0)
+            << std::setw(8) << double(n) * passes / secs / 1e6 << " M elements/s\n";
+    };
+
+    std::cout << label << "\n";
+    auto t0 = Clock::now();
+    for (int p = 0; p < passes; ++p)
+    {
+        for (std::size_t i = 0; i < n; ++i) expected[i] = context.doOperation(a[i], b[i]);
+    }
+    report("doOperation(int, int)", Clock::now() - t0);
+
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX2 })
+    {
+        if (level > bestSimd()) break;
+        BatchKernel kernel = batchKernel<Op>(level);
+        t0 = Clock::now();
+        for (int p = 0; p < passes; ++p) kernel(a.data(), b.data(), out.data(), n);
+        auto t = Clock::now() - t0;
+        if (out != expected) std::cout << "  MISMATCH in " << simdName(level) << " kernel\n";
+        report(simdName(level), t);
+    }
+}
+
+// 5. Benchmark: the three dispatch modes on a tight per-element loop
+template <class Context>
+double timeDispatch(const Context& context, const std::vector<int>& a, const std::vector<int>& b, long long& sum)
+{
+    using Clock = std::chrono::steady_clock;
+    const std::size_t n = a.size();
+    const int passes = static_cast<int>((std::size_t(1) << 28) / n);
+    auto t0 = Clock::now();
+    for (int p = 0; p < passes; ++p)
+    {
+        for (std::size_t i = 0; i < n; ++i) sum += context.doOperation(a[i], b[i]);
+    }
+    return double(n) * passes / std::chrono::duration<double>(Clock::now() - t0).count() / 1e6;
+}
+
+template <class Strategy>
+void benchDispatch(const char* label, int which, const std::vector<int>& a, const std::vector<int>& b)
+{
+    // `which` comes from a runtime value so the virtual context can't be devirtualized
+    CalculatorContext dynamic;
+    VariantCalculatorContext variant;
+    if (which == 0) { dynamic.setStrategy(std::make_unique<AddStrategy>()); variant.setStrategy(AddStrategy{}); }
+    if (which == 1) { dynamic.setStrategy(std::make_unique<SubtractStrategy>()); variant.setStrategy(SubtractStrategy{}); }
+    if (which == 2) { dynamic.setStrategy(std::make_unique<MultiplyStrategy>()); variant.setStrategy(MultiplyStrategy{}); }
+    StaticCalculatorContext<Strategy> fixed;
+
+    long long s1 = 0, s2 = 0, s3 = 0;
+    double tVirtual = timeDispatch(dynamic, a, b, s1);
+    double tVariant = timeDispatch(variant, a, b, s2);
+    double tStatic = timeDispatch(fixed, a, b, s3);
+    std::cout << std::left << std::setw(10) << label << std::right << std::fixed << std::setprecision(0)
+        << std::setw(10) << tVirtual << std::setw(10) << tVariant << std::setw(10) << tStatic
+        << (s1 == s2 && s2 == s3 ? "" : "  MISMATCH") << "\n";
+}
+
+// 6. Stress test: readers compute while a writer keeps swapping strategies
+void benchHotSwap()
+{
+    using Clock = std::chrono::steady_clock;
+    const int readers = 32;
+    const int callsPerReader = 2'000'000;
+
+    // Every result must come from one of the three strategies, never freed memory
+    auto valid = [](int a, int b, int r) { return r == a + b || r == a - b || r == a * b; };
+
+    auto runReaders = [&](auto&& call) -> std::pair<double, long long>
+    {
+        std::atomic<long long> bad{ 0 };
+        std::vector<std::thread> threads;
+        auto t0 = Clock::now();
+        for (int t = 0; t < readers; ++t)
+        {
+            threads.emplace_back([&, t]
+            {
+                auto work = call();
+                long long localBad = 0;
+                for (int i = 0; i < callsPerReader; ++i)
+                {
+                    int a = i & 0xffff, b = t + 1;
+                    if (!valid(a, b, work(a, b))) ++localBad;
+                }
+                bad += localBad;
+            });
+        }
+        for (auto& th : threads) th.join();
+        double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+        return { double(readers) * callsPerReader / secs / 1e6, bad.load() };
+    };
+
+    std::cout << "\nHot swap: " << readers << " readers x " << callsPerReader << " calls\n";
+
+    // Baseline: no synchronization, so no swaps are allowed while it runs
+    CalculatorContext plain;
+    plain.setStrategy(std::make_unique<AddStrategy>());
+    auto [plainRate, plainBad] = runReaders([&]
+    {
+        return [&](int a, int b) { return plain.doOperation(a, b); };
+    });
+
+    ConcurrentCalculatorContext shared;
+    shared.setStrategy(std::make_unique<AddStrategy>());
+    auto [idleRate, idleBad] = runReaders([&]
+    {
+        return [r = std::make_shared<ConcurrentCalculatorContext::Reader>(shared.reader())](int a, int b)
+        {
+            return r->doOperation(a, b);
+        };
+    });
+
+    std::atomic<bool> stop{ false };
+    long long swaps = 0;
+    std::thread writer([&]
+    {
+        for (int k = 0; !stop.load(std::memory_order_relaxed); ++k, ++swaps)
+        {
+            switch (k % 3)
+            {
+            case 0: shared.setStrategy(std::make_unique<AddStrategy>()); break;
+            case 1: shared.setStrategy(std::make_unique<SubtractStrategy>()); break;
+            default: shared.setStrategy(std::make_unique<MultiplyStrategy>()); break;
+            }
+        }
+    });
+    auto [swapRate, swapBad] = runReaders([&]
+    {
+        return [r = std::make_shared<ConcurrentCalculatorContext::Reader>(shared.reader())](int a, int b)
+        {
+            return r->doOperation(a, b);
+        };
+    });
+    stop = true;
+    writer.join();
+    const std::size_t pending = shared.pendingReclaim();
+    shared.collect();
+
+    std::cout << std::fixed << std::setprecision(0)
+        << "  unsynchronized, no swaps  " << std::setw(8) << plainRate << " M calls/s\n"
+        << "  concurrent, no swaps      " << std::setw(8) << idleRate << " M calls/s\n"
+        << "  concurrent, swapping      " << std::setw(8) << swapRate << " M calls/s  ("
+        << swaps << " swaps, " << pending << " awaiting reclaim, "
+        << shared.pendingReclaim() << " after readers left)\n";
+    if (plainBad + idleBad + swapBad != 0) std::cout << "  INVALID RESULTS: " << plainBad + idleBad + swapBad << "\n";
+}
+
+// 7. Benchmark: (a + b) * c chained through full arrays vs one fused pass.
+// Traffic is counted, not measured: each array read or written counts once,
+// so write-allocate reads of the outputs are left out. A plain copy, counted
+// the same way, gives a measured rate to compare against.
+void benchPipeline()
+{
+    using Clock = std::chrono::steady_clock;
+    const std::size_t n = 100'000'000;
+    const double gib = double(1 << 30);
+
+    std::vector<int> a(n), b(n), c(n), tmp(n), chained(n), fused(n);
+    std::uint32_t x = 12345;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        x = x * 1664525u + 1013904223u;
+        a[i] = int(x >> 20);
+        b[i] = int((x >> 8) & 0xfff);
+        c[i] = int(x & 0xff) - 128;
+    }
+
+    auto report = [&](const char* how, Clock::duration t, std::size_t arraysTouched)
+    {
+        double secs = std::chrono::duration<double>(t).count();
+        double bytes = double(arraysTouched) * n * sizeof(int);
+        std::cout << "  " << std::left << std::setw(10) << how << std::right << std::fixed << std::setprecision(1)
+            << std::setw(8) << secs * 1e3 << " ms" << std::setw(8) << bytes / gib << " GiB counted"
+            << std::setw(8) << bytes / gib / secs << " GiB/s\n";
+    };
+
+    std::cout << "\n(a + b) * c over " << n << " elements (GiB counts every array read or written once)\n";
+
+    // Baseline: reads one array and writes one, as fast as the memory allows
+    auto t0 = Clock::now();
+    std::copy(a.begin(), a.end(), tmp.begin());
+    report("copy", Clock::now() - t0, 2);
+
+    // Every step reads two full arrays and writes one
+    CalculatorContext context;
+    t0 = Clock::now();
+    context.setStrategy(std::make_unique<AddStrategy>());
+    context.doOperation(a, b, tmp);
+    context.setStrategy(std::make_unique<MultiplyStrategy>());
+    context.doOperation(tmp, c, chained);
+    report("chained", Clock::now() - t0, 6);
+
+    // Reads each input once, writes the result once
+    const Pipeline expr = Pipeline::apply(std::make_shared<MultiplyStrategy>(),
+        Pipeline::apply(std::make_shared<AddStrategy>(), Pipeline::input(0), Pipeline::input(1)),
+        Pipeline::input(2));
+    t0 = Clock::now();
+    expr.run({ a, b, c }, fused);
+    report("fused", Clock::now() - t0, 4);
+
+    if (fused != chained) std::cout << "  MISMATCH between chained and fused results\n";
+}
+
+// 8. Autotuning: tune each size bucket on first use, then round-trip the profile
+void benchAutotune()
+{
+    auto tuner = Autotuner::standard();
+    CalculatorContext tuned, reference;
+    tuned.setAutotuner(tuner);
+
+    std::mt19937 rng{ 11 };
+    std::uniform_int_distribution<int> dist(-30000, 30000);
+    long long mismatches = 0;
+    for (std::size_t n = 16; n <= (std::size_t(1) << 24); n <<= 4)
+    {
+        std::vector<int> a(n), b(n), got(n), expected(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            a[i] = dist(rng);
+            b[i] = dist(rng);
+        }
+        for (int op = 0; op < 3; ++op)
+        {
+            std::unique_ptr<OperationStrategy> s1, s2;
+            if (op == 0) { s1 = std::make_unique<AddStrategy>(); s2 = std::make_unique<AddStrategy>(); }
+            if (op == 1) { s1 = std::make_unique<SubtractStrategy>(); s2 = std::make_unique<SubtractStrategy>(); }
+            if (op == 2) { s1 = std::make_unique<MultiplyStrategy>(); s2 = std::make_unique<MultiplyStrategy>(); }
+            tuned.setStrategy(std::move(s1));
+            reference.setStrategy(std::move(s2));
+            tuned.doOperation(a, b, got); // tunes this bucket
+            reference.doOperation(a, b, expected);
+            if (got != expected) ++mismatches;
+            tuned.doOperation(a, b, got); // dispatches from the plan
+            if (got != expected) ++mismatches;
+        }
+    }
+
+    // In place on a bucket that still needs tuning: out aliases a
+    {
+        CalculatorContext inPlace;
+        inPlace.setAutotuner(Autotuner::standard());
+        inPlace.setStrategy(std::make_unique<AddStrategy>());
+        std::vector<int> ones(100, 1);
+        inPlace.doOperation(ones, ones, ones);
+        if (std::count(ones.begin(), ones.end(), 2) != 100) ++mismatches;
+    }
+
+    std::cout << "\nAutotuned plan (" << std::max(1u, std::thread::hardware_concurrency()) << " hardware threads)\n";
+    tuner->printPlan(std::cout);
+    if (mismatches != 0) std::cout << "  MISMATCH in " << mismatches << " autotuned batches\n";
+
+    const std::string path = (std::filesystem::temp_directory_path() / "strategy_autotune.profile").string();
+    tuner->saveProfile(path);
+    auto restored = Autotuner::standard();
+    restored->loadProfile(path);
+    auto before = tuner->plan(), after = restored->plan();
+    bool same = before.size() == after.size();
+    for (std::size_t i = 0; same && i < before.size(); ++i)
+    {
+        same = before[i].strategy == after[i].strategy && before[i].bucket == after[i].bucket
+            && before[i].implementation == after[i].implementation;
+    }
+    std::cout << "  profile " << path << (same ? " reloads to the same plan\n" : " reloaded DIFFERENTLY\n");
+    std::filesystem::remove(path);
+}
+
+void runBenchmark()
+{
+    const std::size_t n = 1 << 13; // 96 KiB of operands + results: cache-resident
+    std::mt19937 rng{ 7 };
+    std::uniform_int_distribution<int> dist(-30000, 30000); // products stay in range
+    std::vector<int> a(n), b(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        a[i] = dist(rng);
+        b[i] = dist(rng);
+    }
+
+    std::cout << "Batch execute over " << n << " operand pairs, best SIMD: " << simdName(bestSimd()) << "\n";
+    benchOperation<AddOp, AddStrategy>("Add", a, b);
+    benchOperation<SubtractOp, SubtractStrategy>("Subtract", a, b);
+    benchOperation<MultiplyOp, MultiplyStrategy>("Multiply", a, b);
+
+    // volatile so the selector is a genuine runtime value
+    volatile int selector[] = { 0, 1, 2 };
+    std::cout << "\nDispatch modes, M doOperation(int, int) calls/s\n"
+        << "              virtual   variant    static\n";
+    benchDispatch<AddStrategy>("Add", selector[0], a, b);
+    benchDispatch<SubtractStrategy>("Subtract", selector[1], a, b);
+    benchDispatch<MultiplyStrategy>("Multiply", selector[2], a, b);
+
+    benchHotSwap();
+    benchPipeline();
+    benchAutotune();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0)
+    {
+        runBenchmark();
+        return 0;
+    }
+
     CalculatorContext context;
 
     // Use AddStrategy
@@ -77,5 +1249,53 @@ int main()
     context.setStrategy(std::make_unique<MultiplyStrategy>());
     std::cout << "10 * 5 = " << context.doOperation(10, 5) << "\n";
 
+    // Same strategy over whole arrays in one call
+    const std::vector<int> xs = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    const std::vector<int> ys = { 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+    std::vector<int> products(xs.size());
+    context.doOperation(xs, ys, products);
+    std::cout << "xs * ys = [";
+    for (std::size_t i = 0; i < products.size(); ++i)
+    {
+        std::cout << products[i] << (i + 1 < products.size() ? ", " : "");
+    }
+    std::cout << "] (" << simdName(bestSimd()) << ")\n";
+
+    // (xs + ys) * xs in one pass, without an intermediate array
+    const Pipeline expr = Pipeline::apply(std::make_shared<MultiplyStrategy>(),
+        Pipeline::apply(std::make_shared<AddStrategy>(), Pipeline::input(0), Pipeline::input(1)),
+        Pipeline::input(0));
+    std::vector<int> fused(xs.size());
+    expr.run({ xs, ys }, fused);
+    std::cout << "(xs + ys) * xs = [";
+    for (std::size_t i = 0; i < fused.size(); ++i)
+    {
+        std::cout << fused[i] << (i + 1 < fused.size() ? ", " : "");
+    }
+    std::cout << "]\n";
+
+    // Same strategies without a heap-allocated, virtually-called strategy object
+    StaticCalculatorContext<AddStrategy> adder;
+    std::cout << "static:  10 + 5 = " << adder.doOperation(10, 5) << "\n";
+
+    VariantCalculatorContext variant;
+    variant.setStrategy(SubtractStrategy{});
+    std::cout << "variant: 10 - 5 = " << variant.doOperation(10, 5) << "\n";
+    variant.setStrategy(MultiplyStrategy{});
+    std::cout << "variant: 10 * 5 = " << variant.doOperation(10, 5) << "\n";
+
+    // Shared between threads: swaps are safe while readers compute
+    ConcurrentCalculatorContext shared;
+    shared.setStrategy(std::make_unique<AddStrategy>());
+    auto reader = shared.reader();
+    std::cout << "concurrent: 10 + 5 = " << reader.doOperation(10, 5) << "\n";
+    shared.setStrategy(std::make_unique<MultiplyStrategy>());
+    std::thread worker([&shared]
+    {
+        auto r = shared.reader();
+        std::cout << "concurrent: 10 * 5 = " << r.doOperation(10, 5) << "\n";
+    });
+    worker.join();
+
     return 0;
 }